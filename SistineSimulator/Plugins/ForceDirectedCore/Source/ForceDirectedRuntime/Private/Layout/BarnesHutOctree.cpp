@@ -0,0 +1,229 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Layout/BarnesHutOctree.h"
+
+#include <algorithm>
+
+namespace ForceDirected
+{
+	namespace
+	{
+		// Pairs closer than this are considered coincident and do not repulse
+		constexpr float GOctree_Min_Distance = 1.e-4f;
+	}
+
+	size_t FBarnesHutOctree::GetAllocatedSize() const
+	{
+		return Cells.capacity() * sizeof(FCell) + NextBody.capacity() * sizeof(int32_t);
+	}
+
+	void FBarnesHutOctree::Reset()
+	{
+		Cells.clear();
+		NextBody.clear();
+		Positions = nullptr;
+	}
+
+	void FBarnesHutOctree::Build(const FLayoutBuffers& InPositions)
+	{
+		Reset();
+		Positions = &InPositions;
+
+		const int32_t NumBodies = InPositions.Num();
+		if (NumBodies == 0)
+			return;
+
+		// Root cell is the bounding cube of all positions, padded so no body sits exactly on the boundary
+		FVec3 Min = InPositions.Get(0);
+		FVec3 Max = Min;
+		for (int32_t i = 1; i < NumBodies; ++i)
+		{
+			const FVec3 Point = InPositions.Get(i);
+			Min = FVec3(std::min(Min.X, Point.X), std::min(Min.Y, Point.Y), std::min(Min.Z, Point.Z));
+			Max = FVec3(std::max(Max.X, Point.X), std::max(Max.Y, Point.Y), std::max(Max.Z, Point.Z));
+		}
+		const FVec3 Size = Max - Min;
+		const float HalfExtent = 0.5f * std::max(Size.X, std::max(Size.Y, Size.Z)) + 1.f;
+
+		Cells.reserve(static_cast<size_t>(NumBodies) * 2);
+		NextBody.assign(NumBodies, InvalidIndex);
+		AddCell((Min + Max) * 0.5f, HalfExtent, 0);
+
+		for (int32_t i = 0; i < NumBodies; ++i)
+		{
+			Insert(i);
+		}
+
+		// Children are always allocated after their parent, so walking backwards aggregates bottom-up
+		for (int32_t c = static_cast<int32_t>(Cells.size()) - 1; c >= 0; --c)
+		{
+			FCell& Cell = Cells[c];
+			FVec3 WeightedSum;
+			int32_t Mass = 0;
+
+			if (Cell.FirstChild == InvalidIndex)
+			{
+				for (int32_t Body = Cell.FirstBody; Body != InvalidIndex; Body = NextBody[Body])
+				{
+					WeightedSum += InPositions.Get(Body);
+					++Mass;
+				}
+			}
+			else
+			{
+				for (int32_t Child = Cell.FirstChild; Child < Cell.FirstChild + 8; ++Child)
+				{
+					WeightedSum += Cells[Child].CenterOfMass * static_cast<float>(Cells[Child].Mass);
+					Mass += Cells[Child].Mass;
+				}
+			}
+
+			Cell.Mass = Mass;
+			Cell.CenterOfMass = Mass > 0 ? WeightedSum / static_cast<float>(Mass) : Cell.Center;
+		}
+	}
+
+	FVec3 FBarnesHutOctree::ComputeRepulsion(const int32_t NodeIndex, const float KSquared, const float Theta,
+	                                         const float MaxDistance) const
+	{
+		FVec3 Force;
+		if (!Positions || Cells.empty())
+			return Force;
+
+		const FVec3 Position = Positions->Get(NodeIndex);
+		const float MaxDistanceSquared = MaxDistance * MaxDistance;
+
+		// Depth-first traversal; at most 7 siblings are pending per level
+		int32_t Stack[MaxDepth * 7 + 8];
+		int32_t StackSize = 0;
+		Stack[StackSize++] = 0;
+
+		while (StackSize > 0)
+		{
+			const FCell& Cell = Cells[Stack[--StackSize]];
+			if (Cell.Mass == 0)
+				continue;
+
+			// Skip the whole cell if even its closest point is beyond the cutoff
+			const FVec3 Outside(std::max(std::abs(Position.X - Cell.Center.X) - Cell.HalfExtent, 0.f),
+			                    std::max(std::abs(Position.Y - Cell.Center.Y) - Cell.HalfExtent, 0.f),
+			                    std::max(std::abs(Position.Z - Cell.Center.Z) - Cell.HalfExtent, 0.f));
+			if (Outside.SizeSquared() > MaxDistanceSquared)
+				continue;
+
+			if (Cell.FirstChild == InvalidIndex)
+			{
+				for (int32_t Body = Cell.FirstBody; Body != InvalidIndex; Body = NextBody[Body])
+				{
+					if (Body == NodeIndex)
+						continue;
+
+					const FVec3 Delta = Position - Positions->Get(Body);
+					const float Dist = Delta.Size();
+					if (Dist < GOctree_Min_Distance || Dist > MaxDistance)
+						continue;
+
+					Force += Delta * (KSquared / (Dist * Dist));
+				}
+				continue;
+			}
+
+			// Far enough away: treat the whole cell as one body at its center of mass
+			const FVec3 Delta = Position - Cell.CenterOfMass;
+			const float Dist = Delta.Size();
+			if (Dist > GOctree_Min_Distance && 2.f * Cell.HalfExtent < Theta * Dist)
+			{
+				if (Dist <= MaxDistance)
+				{
+					Force += Delta * (static_cast<float>(Cell.Mass) * KSquared / (Dist * Dist));
+				}
+				continue;
+			}
+
+			for (int32_t Child = Cell.FirstChild; Child < Cell.FirstChild + 8; ++Child)
+			{
+				Stack[StackSize++] = Child;
+			}
+		}
+
+		return Force;
+	}
+
+	int32_t FBarnesHutOctree::AddCell(const FVec3& Center, const float HalfExtent, const int32_t Depth)
+	{
+		FCell Cell;
+		Cell.Center = Center;
+		Cell.HalfExtent = HalfExtent;
+		Cell.CenterOfMass = Center;
+		Cell.Depth = Depth;
+		Cells.push_back(Cell);
+		return static_cast<int32_t>(Cells.size()) - 1;
+	}
+
+	void FBarnesHutOctree::Insert(const int32_t BodyIndex)
+	{
+		const FVec3 Point = Positions->Get(BodyIndex);
+		int32_t CellIndex = 0;
+
+		while (true)
+		{
+			const FCell& Cell = Cells[CellIndex];
+			if (Cell.FirstChild != InvalidIndex)
+			{
+				CellIndex = Cell.FirstChild + GetOctant(Cell.Center, Point);
+				continue;
+			}
+
+			// Empty leaf, or coincident bodies that cannot be separated any further
+			if (Cell.FirstBody == InvalidIndex || Cell.Depth >= MaxDepth)
+			{
+				NextBody[BodyIndex] = Cell.FirstBody;
+				Cells[CellIndex].FirstBody = BodyIndex;
+				return;
+			}
+
+			// Occupied leaf: push its body down one level and keep descending
+			Subdivide(CellIndex);
+		}
+	}
+
+	void FBarnesHutOctree::Subdivide(const int32_t CellIndex)
+	{
+		// Copy what we need up front, AddCell may reallocate the array
+		const FVec3 Center = Cells[CellIndex].Center;
+		const float ChildExtent = 0.5f * Cells[CellIndex].HalfExtent;
+		const int32_t ChildDepth = Cells[CellIndex].Depth + 1;
+
+		int32_t FirstChild = InvalidIndex;
+		for (int32_t Octant = 0; Octant < 8; ++Octant)
+		{
+			const FVec3 Offset((Octant & 1) ? ChildExtent : -ChildExtent,
+			                   (Octant & 2) ? ChildExtent : -ChildExtent,
+			                   (Octant & 4) ? ChildExtent : -ChildExtent);
+			const int32_t Child = AddCell(Center + Offset, ChildExtent, ChildDepth);
+			if (Octant == 0)
+			{
+				FirstChild = Child;
+			}
+		}
+
+		FCell& Cell = Cells[CellIndex];
+		Cell.FirstChild = FirstChild;
+
+		int32_t Body = Cell.FirstBody;
+		Cell.FirstBody = InvalidIndex;
+		while (Body != InvalidIndex)
+		{
+			const int32_t Next = NextBody[Body];
+			FCell& Child = Cells[FirstChild + GetOctant(Center, Positions->Get(Body))];
+			NextBody[Body] = Child.FirstBody;
+			Child.FirstBody = Body;
+			Body = Next;
+		}
+	}
+
+	int32_t FBarnesHutOctree::GetOctant(const FVec3& Center, const FVec3& Point)
+	{
+		return (Point.X >= Center.X ? 1 : 0) | (Point.Y >= Center.Y ? 2 : 0) | (Point.Z >= Center.Z ? 4 : 0);
+	}
+}
@@ -0,0 +1,598 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Layout/FruchtermanReingoldSolver.h"
+#include "Layout/LayoutKernels.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace ForceDirected
+{
+	namespace
+	{
+		// Pairs closer than this are considered coincident during local steps and do not interact
+		constexpr float GLocal_Min_Distance = 1.e-4f;
+
+		// Offset of a new node from the centroid of its neighbors, in K. Spread on a golden angle spiral by
+		// node index so siblings added together don't start on top of each other.
+		constexpr float GSeed_Offset_Scale = 0.5f;
+
+		using FClock = std::chrono::steady_clock;
+
+		double SecondsBetween(const FClock::time_point Begin, const FClock::time_point End)
+		{
+			return std::chrono::duration<double>(End - Begin).count();
+		}
+
+		FVec3 SeedOffset(const int32_t Node, const float Radius)
+		{
+			const float Angle = 2.39996323f * static_cast<float>(Node);
+			const float Z = 1.f - 2.f * std::fmod(0.618034f * static_cast<float>(Node), 1.f);
+			const float Ring = std::sqrt(std::max(1.f - Z * Z, 0.f));
+			return FVec3(std::cos(Angle) * Ring, std::sin(Angle) * Ring, Z) * Radius;
+		}
+	}
+
+	void FFruchtermanReingoldSolver::SetGraph(const int32_t InNumNodes, const std::vector<FEdge>& InEdges)
+	{
+		Graph.Build(InNumNodes, InEdges);
+		const int32_t NumNodes = Graph.GetNumNodes();
+
+		Positions.SetNumZeroed(NumNodes);
+		Movements.SetNumZeroed(NumNodes);
+		Displacements.SetNumZeroed(NumNodes);
+		Octree.Reset();
+		Grid.Reset();
+		MaxDisplacement = 0.f;
+		MaxDrift = 0.f;
+		Energy = 0.f;
+		LastStepTimings = FStepTimings();
+		Stress.Reset();
+		EndLocalRelayout();
+		ResetConvergence();
+		StressPass = 0;
+		ResetTemperature();
+	}
+
+	int32_t FFruchtermanReingoldSolver::UpdateGraph(const int32_t InNumNodes, const std::vector<FEdge>& InEdges,
+	                                                const std::vector<int32_t>& PreviousNodes,
+	                                                const FLayoutBuffers& HostPositions)
+	{
+		const FLayoutGraph PreviousGraph = std::move(Graph);
+		const FLayoutBuffers PreviousPositions = std::move(Positions);
+		const int32_t NumPreviousNodes = PreviousGraph.GetNumNodes();
+
+		Graph.Build(InNumNodes, InEdges);
+		const int32_t NumNodes = Graph.GetNumNodes();
+		Positions.SetNumZeroed(NumNodes);
+		Movements.SetNumZeroed(NumNodes);
+		Displacements.SetNumZeroed(NumNodes);
+		Octree.Reset();
+		Grid.Reset();
+		Stress.Reset();
+		EndLocalRelayout();
+
+		auto PreviousIndex = [&PreviousNodes, NumPreviousNodes](const int32_t Node)
+		{
+			const int32_t Previous = Node < static_cast<int32_t>(PreviousNodes.size()) ? PreviousNodes[Node] : InvalidIndex;
+			return Previous >= 0 && Previous < NumPreviousNodes ? Previous : InvalidIndex;
+		};
+
+		// Kept nodes stay where they were. A node changed if it is new or its neighbors differ from before,
+		// which also catches the neighbors of removed nodes.
+		std::vector<int32_t> Changed;
+		std::vector<uint8_t> Placed(NumNodes, 0);
+		std::vector<int32_t> MappedNeighbors;
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			const int32_t Previous = PreviousIndex(v);
+			if (Previous == InvalidIndex)
+			{
+				Changed.push_back(v);
+				continue;
+			}
+
+			Positions.Set(v, PreviousPositions.Get(Previous));
+			Placed[v] = 1;
+
+			MappedNeighbors.clear();
+			for (const int32_t* u = Graph.NeighborsBegin(v); u != Graph.NeighborsEnd(v); ++u)
+			{
+				MappedNeighbors.push_back(PreviousIndex(*u));
+			}
+			std::sort(MappedNeighbors.begin(), MappedNeighbors.end());
+			if (!std::equal(MappedNeighbors.begin(), MappedNeighbors.end(),
+			                PreviousGraph.NeighborsBegin(Previous), PreviousGraph.NeighborsEnd(Previous)))
+			{
+				Changed.push_back(v);
+			}
+		}
+
+		// Place new nodes next to the centroid of their placed neighbors, growing outwards from the kept layout
+		const float SeedRadius = GSeed_Offset_Scale * Settings.KConstant;
+		std::vector<int32_t> Frontier;
+		for (const int32_t v : Changed)
+		{
+			if (!Placed[v])
+			{
+				Frontier.push_back(v);
+			}
+		}
+		while (!Frontier.empty())
+		{
+			// Nodes placed in this round only count from the next one, so the order within a round doesn't matter
+			std::vector<int32_t> Remaining, NewlyPlaced;
+			for (const int32_t v : Frontier)
+			{
+				FVec3 Centroid;
+				int32_t NumPlaced = 0;
+				for (const int32_t* u = Graph.NeighborsBegin(v); u != Graph.NeighborsEnd(v); ++u)
+				{
+					if (Placed[*u] == 1)
+					{
+						Centroid += Positions.Get(*u);
+						++NumPlaced;
+					}
+				}
+				if (NumPlaced == 0)
+				{
+					Remaining.push_back(v);
+					continue;
+				}
+				Positions.Set(v, Centroid / static_cast<float>(NumPlaced) + SeedOffset(v, SeedRadius));
+				NewlyPlaced.push_back(v);
+			}
+			if (NewlyPlaced.empty())
+				break;
+
+			for (const int32_t v : NewlyPlaced)
+			{
+				Placed[v] = 1;
+			}
+			Frontier = std::move(Remaining);
+		}
+
+		// Whatever is not connected to the kept layout starts where the host put it
+		for (const int32_t v : Frontier)
+		{
+			if (v < HostPositions.Num())
+			{
+				Positions.Set(v, HostPositions.Get(v));
+			}
+		}
+
+		// Everything within IncrementalHops of a changed node gets relaxed
+		std::vector<int32_t> Hops(NumNodes, -1);
+		for (const int32_t v : Changed)
+		{
+			Hops[v] = 0;
+			ActiveNodes.push_back(v);
+		}
+		for (size_t Next = 0; Next < ActiveNodes.size(); ++Next)
+		{
+			const int32_t v = ActiveNodes[Next];
+			if (Hops[v] >= Settings.IncrementalHops)
+				continue;
+
+			for (const int32_t* u = Graph.NeighborsBegin(v); u != Graph.NeighborsEnd(v); ++u)
+			{
+				if (Hops[*u] < 0)
+				{
+					Hops[*u] = Hops[v] + 1;
+					ActiveNodes.push_back(*u);
+				}
+			}
+		}
+
+		ResetConvergence();
+		MaxDisplacement = 0.f;
+		MaxDrift = 0.f;
+		Energy = 0.f;
+
+		const int32_t NumActive = GetNumActiveNodes();
+		if (NumActive == 0 || NumActive == NumNodes)
+		{
+			// Nothing changed, or everything did and a regular global solve is just as cheap
+			EndLocalRelayout();
+			if (NumActive == NumNodes)
+			{
+				ResetTemperature();
+			}
+			return NumActive;
+		}
+
+		// The frozen nodes don't move while the neighborhood relaxes, so their grid is built once
+		std::sort(ActiveNodes.begin(), ActiveNodes.end());
+		FLayoutBuffers FrozenPositions;
+		FrozenPositions.SetNumZeroed(NumNodes - NumActive);
+		for (int32_t v = 0, Frozen = 0; v < NumNodes; ++v)
+		{
+			if (Hops[v] < 0)
+			{
+				FrozenPositions.Set(Frozen++, Positions.Get(v));
+			}
+		}
+		FrozenGrid.Build(FrozenPositions, Settings.RepulsionCutoff);
+
+		// Hot enough to untangle the neighborhood, not the whole graph
+		Temperature = std::max(10.f * std::sqrt(static_cast<float>(NumActive)), Settings.MinTemperature);
+		return NumActive;
+	}
+
+	void FFruchtermanReingoldSolver::EndLocalRelayout()
+	{
+		ActiveNodes.clear();
+		FrozenGrid.Reset();
+	}
+
+	size_t FFruchtermanReingoldSolver::GetAllocatedSize() const
+	{
+		size_t Size = Graph.GetAllocatedSize() + Positions.GetAllocatedSize() + Movements.GetAllocatedSize()
+			+ Displacements.GetAllocatedSize() + Octree.GetAllocatedSize() + Grid.GetAllocatedSize()
+			+ FrozenGrid.GetAllocatedSize() + ActiveNodes.capacity() * sizeof(int32_t)
+			+ TaskForces.capacity() * sizeof(FLayoutBuffers)
+			+ (TaskMaxDisplacementSquared.capacity() + TaskMaxDriftSquared.capacity()) * sizeof(float)
+			+ TaskEnergy.capacity() * sizeof(double) + Stress.GetAllocatedSize();
+		for (const FLayoutBuffers& Forces : TaskForces)
+		{
+			Size += Forces.GetAllocatedSize();
+		}
+		return Size;
+	}
+
+	void FFruchtermanReingoldSolver::SetSettings(const FSolverSettings& InSettings)
+	{
+		if (InSettings.StressAllPairsNodes != Settings.StressAllPairsNodes
+			|| InSettings.StressPivots != Settings.StressPivots)
+		{
+			Stress.Reset();
+		}
+		Settings = InSettings;
+	}
+
+	bool FFruchtermanReingoldSolver::IsConverged() const
+	{
+		if (Settings.Algorithm == ELayoutAlgorithm::StressMajorization)
+			return StressPass >= Settings.StressIterations;
+
+		return Settings.ConvergenceIterations > 0 && NumQuietIterations >= Settings.ConvergenceIterations;
+	}
+
+	void FFruchtermanReingoldSolver::ResetConvergence()
+	{
+		NumQuietIterations = 0;
+
+		// The coarse passes would redo the whole layout, the fine ones only settle what was disturbed
+		StressPass = std::min(StressPass, Settings.StressIterations / 2);
+	}
+
+	void FFruchtermanReingoldSolver::ResetTemperature()
+	{
+		Temperature = 10.f * std::sqrt(static_cast<float>(Graph.GetNumNodes()));
+	}
+
+	void FFruchtermanReingoldSolver::SetTemperature(const float InTemperature)
+	{
+		Temperature = std::max(InTemperature, Settings.MinTemperature);
+		StressPass = std::max(StressPass, Settings.StressIterations / 2);
+	}
+
+	void FFruchtermanReingoldSolver::Step()
+	{
+		const int32_t NumNodes = Graph.GetNumNodes();
+		if (NumNodes == 0)
+			return;
+
+		if (Settings.Algorithm == ELayoutAlgorithm::StressMajorization)
+		{
+			StepStress();
+			return;
+		}
+
+		if (IsRelaxingLocally())
+		{
+			StepLocal();
+			return;
+		}
+
+		// With a single task everything runs inline and accumulates straight into Movements.
+		// Otherwise each task owns a private accumulator which is reduced into Movements at the end,
+		// so the inner loops never write to shared memory.
+		const int32_t NumTasks = std::clamp(Settings.NumTasks, 1, NumNodes);
+		const bool bSingleTask = NumTasks == 1;
+		const float KSquared = Settings.KConstant * Settings.KConstant;
+
+		// Forces are recomputed from scratch every step. Carrying them over acts like a velocity without
+		// damping and keeps every node drifting at MinTemperature forever.
+		Movements.SetNumZeroed(NumNodes);
+
+		if (bSingleTask)
+		{
+			TaskForces.clear();
+		}
+		else
+		{
+			TaskForces.resize(NumTasks);
+			for (FLayoutBuffers& Forces : TaskForces)
+			{
+				Forces.SetNumZeroed(NumNodes);
+			}
+		}
+
+		auto NodeRange = [NumNodes, NumTasks](const int32_t Task, int32_t& OutBegin, int32_t& OutEnd)
+		{
+			OutBegin = static_cast<int32_t>(static_cast<int64_t>(NumNodes) * Task / NumTasks);
+			OutEnd = static_cast<int32_t>(static_cast<int64_t>(NumNodes) * (Task + 1) / NumTasks);
+		};
+
+		const FClock::time_point RepulsionStart = FClock::now();
+
+		// Repulsion. Every path computes each node's force independently and only writes its own entry,
+		// so they go directly into Movements.
+		ERepulsionMethod RepulsionMethod = Settings.RepulsionMethod;
+		if (RepulsionMethod == ERepulsionMethod::BarnesHut && Settings.Theta <= 0.f)
+		{
+			RepulsionMethod = ERepulsionMethod::Exact;
+		}
+
+		if (RepulsionMethod == ERepulsionMethod::SpatialHash)
+		{
+			// Only neighboring cells can be within the cutoff
+			Grid.Build(Positions, Settings.RepulsionCutoff);
+			RunTasks(ParallelFor, NumTasks, [this, &NodeRange, KSquared](const int32_t Task)
+			{
+				int32_t Begin, End;
+				NodeRange(Task, Begin, End);
+				for (int32_t v = Begin; v < End; ++v)
+				{
+					Movements.Add(v, Grid.ComputeRepulsion(v, KSquared));
+				}
+			});
+		}
+		else if (RepulsionMethod == ERepulsionMethod::BarnesHut)
+		{
+			// Approximate repulsion through the octree
+			Octree.Build(Positions);
+			RunTasks(ParallelFor, NumTasks, [this, &NodeRange, KSquared](const int32_t Task)
+			{
+				int32_t Begin, End;
+				NodeRange(Task, Begin, End);
+				for (int32_t v = Begin; v < End; ++v)
+				{
+					Movements.Add(v, Octree.ComputeRepulsion(v, KSquared, Settings.Theta, Settings.RepulsionCutoff));
+				}
+			});
+		}
+		else
+		{
+			// Exact repulsion between all pairs
+			RunTasks(ParallelFor, NumTasks, [this, &NodeRange, KSquared](const int32_t Task)
+			{
+				int32_t Begin, End;
+				NodeRange(Task, Begin, End);
+				if (Settings.bUseSimd)
+				{
+					FLayoutKernels::RepulsionSimd(Positions, Begin, End, KSquared, Settings.RepulsionCutoff, Movements);
+				}
+				else
+				{
+					FLayoutKernels::RepulsionScalar(Positions, Begin, End, KSquared, Settings.RepulsionCutoff, Movements);
+				}
+			});
+		}
+
+		const FClock::time_point AttractionStart = FClock::now();
+
+		// Attraction along each unique edge once, split by edge ranges
+		const std::vector<FEdge>& Edges = Graph.GetEdges();
+		const int32_t NumEdges = Graph.GetNumEdges();
+		RunTasks(ParallelFor, NumTasks, [this, &Edges, NumTasks, NumEdges, bSingleTask](const int32_t Task)
+		{
+			const int32_t Begin = static_cast<int32_t>(static_cast<int64_t>(NumEdges) * Task / NumTasks);
+			const int32_t End = static_cast<int32_t>(static_cast<int64_t>(NumEdges) * (Task + 1) / NumTasks);
+			FLayoutKernels::Attraction(Positions, Edges.data(), Begin, End, Settings.KConstant,
+			                           bSingleTask ? Movements : TaskForces[Task]);
+		});
+
+		const FClock::time_point ApplyStart = FClock::now();
+
+		// Reduce the per-task accumulators, cap movement by temperature and move the nodes
+		TaskMaxDisplacementSquared.assign(NumTasks, 0.f);
+		TaskMaxDriftSquared.assign(NumTasks, 0.f);
+		TaskEnergy.assign(NumTasks, 0.0);
+		RunTasks(ParallelFor, NumTasks, [this, &NodeRange](const int32_t Task)
+		{
+			int32_t Begin, End;
+			NodeRange(Task, Begin, End);
+			float MaxSquared = 0.f;
+			float MaxDriftSquared = 0.f;
+			double SumDriftSquared = 0.0;
+			for (int32_t v = Begin; v < End; ++v)
+			{
+				for (const FLayoutBuffers& Forces : TaskForces)
+				{
+					Movements.Add(v, Forces.Get(v));
+				}
+
+				const FVec3 PreviousDisplacement = Displacements.Get(v);
+				const FVec3 Movement = Movements.Get(v);
+				const float MoveNorm = Movement.Size();
+				FVec3 Displacement;
+				// No need to cap movements for those that are already moving very little
+				if (MoveNorm >= Settings.MinMovement)
+				{
+					const float CappedNorm = std::min(MoveNorm, Temperature);
+					Displacement = Movement / MoveNorm * CappedNorm;
+					Positions.Add(v, Displacement);
+					MaxSquared = std::max(MaxSquared, CappedNorm * CappedNorm);
+				}
+				Displacements.Set(v, Displacement);
+
+				const float DriftSquared = ((Displacement + PreviousDisplacement) * 0.5f).SizeSquared();
+				MaxDriftSquared = std::max(MaxDriftSquared, DriftSquared);
+				SumDriftSquared += DriftSquared;
+			}
+			TaskMaxDisplacementSquared[Task] = MaxSquared;
+			TaskMaxDriftSquared[Task] = MaxDriftSquared;
+			TaskEnergy[Task] = SumDriftSquared;
+		});
+
+		float MaxSquared = 0.f;
+		float MaxDriftSquared = 0.f;
+		double SumDriftSquared = 0.0;
+		for (int32_t Task = 0; Task < NumTasks; ++Task)
+		{
+			MaxSquared = std::max(MaxSquared, TaskMaxDisplacementSquared[Task]);
+			MaxDriftSquared = std::max(MaxDriftSquared, TaskMaxDriftSquared[Task]);
+			SumDriftSquared += TaskEnergy[Task];
+		}
+		MaxDisplacement = std::sqrt(MaxSquared);
+		MaxDrift = std::sqrt(MaxDriftSquared);
+		Energy = static_cast<float>(SumDriftSquared);
+		NumQuietIterations = MaxDrift < Settings.ConvergenceThreshold ? NumQuietIterations + 1 : 0;
+
+		// Cool down fast until we reach the minimum, then stay at low temperature
+		if (Temperature > Settings.MinTemperature)
+		{
+			Temperature *= Settings.CoolingFactor;
+		}
+		else
+		{
+			Temperature = Settings.MinTemperature;
+		}
+
+		const FClock::time_point ApplyEnd = FClock::now();
+		LastStepTimings.Repulsion = SecondsBetween(RepulsionStart, AttractionStart);
+		LastStepTimings.Attraction = SecondsBetween(AttractionStart, ApplyStart);
+		LastStepTimings.Apply = SecondsBetween(ApplyStart, ApplyEnd);
+	}
+
+	void FFruchtermanReingoldSolver::StepLocal()
+	{
+		// Neighborhoods are small, so this runs on the calling thread
+		const float KSquared = Settings.KConstant * Settings.KConstant;
+		const float MaxDistanceSquared = Settings.RepulsionCutoff * Settings.RepulsionCutoff;
+		const float MinDistanceSquared = GLocal_Min_Distance * GLocal_Min_Distance;
+
+		const FClock::time_point ForcesStart = FClock::now();
+
+		// Forces for every active node first, so they all see the same positions
+		for (const int32_t v : ActiveNodes)
+		{
+			const FVec3 Position = Positions.Get(v);
+			FVec3 Force = FrozenGrid.ComputeRepulsionAt(Position, KSquared);
+
+			for (const int32_t u : ActiveNodes)
+			{
+				const FVec3 Delta = Position - Positions.Get(u);
+				const float DistSquared = Delta.SizeSquared();
+
+				// Also skips u == v
+				if (DistSquared < MinDistanceSquared || DistSquared > MaxDistanceSquared)
+					continue;
+
+				// Direction * (K^2 / Dist)
+				Force += Delta * (KSquared / DistSquared);
+			}
+
+			// Attraction from every neighbor, frozen or not. Direction * (Distance^2 / K)
+			for (const int32_t* u = Graph.NeighborsBegin(v); u != Graph.NeighborsEnd(v); ++u)
+			{
+				const FVec3 Delta = Position - Positions.Get(*u);
+				const float Distance = Delta.Size();
+				if (Distance >= GLocal_Min_Distance)
+				{
+					Force -= Delta * (Distance / Settings.KConstant);
+				}
+			}
+			Movements.Set(v, Force);
+		}
+
+		const FClock::time_point ApplyStart = FClock::now();
+
+		float MaxSquared = 0.f;
+		float MaxDriftSquared = 0.f;
+		double SumDriftSquared = 0.0;
+		for (const int32_t v : ActiveNodes)
+		{
+			const FVec3 PreviousDisplacement = Displacements.Get(v);
+			const FVec3 Movement = Movements.Get(v);
+			const float MoveNorm = Movement.Size();
+			FVec3 Displacement;
+			if (MoveNorm >= Settings.MinMovement)
+			{
+				const float CappedNorm = std::min(MoveNorm, Temperature);
+				Displacement = Movement / MoveNorm * CappedNorm;
+				Positions.Add(v, Displacement);
+				MaxSquared = std::max(MaxSquared, CappedNorm * CappedNorm);
+			}
+			Displacements.Set(v, Displacement);
+
+			const float DriftSquared = ((Displacement + PreviousDisplacement) * 0.5f).SizeSquared();
+			MaxDriftSquared = std::max(MaxDriftSquared, DriftSquared);
+			SumDriftSquared += DriftSquared;
+		}
+
+		MaxDisplacement = std::sqrt(MaxSquared);
+		MaxDrift = std::sqrt(MaxDriftSquared);
+		Energy = static_cast<float>(SumDriftSquared);
+		NumQuietIterations = MaxDrift < Settings.ConvergenceThreshold ? NumQuietIterations + 1 : 0;
+		Temperature = std::max(Temperature * Settings.CoolingFactor, Settings.MinTemperature);
+
+		LastStepTimings.Repulsion = SecondsBetween(ForcesStart, ApplyStart);
+		LastStepTimings.Attraction = 0.0;
+		LastStepTimings.Apply = SecondsBetween(ApplyStart, FClock::now());
+
+		// Settled, the whole layout is at rest again
+		if (IsConverged())
+		{
+			EndLocalRelayout();
+		}
+	}
+
+	void FFruchtermanReingoldSolver::StepStress()
+	{
+		const int32_t NumNodes = Graph.GetNumNodes();
+
+		// Stress terms already pull every node towards its neighborhood, there is nothing to freeze
+		EndLocalRelayout();
+
+		const FClock::time_point BuildStart = FClock::now();
+		if (!Stress.IsBuilt())
+		{
+			Stress.Build(Graph, Settings.StressAllPairsNodes, Settings.StressPivots, ParallelFor,
+			             std::max(Settings.NumTasks, 1));
+		}
+
+		// Movements holds the positions before the pass
+		const FClock::time_point PassStart = FClock::now();
+		Movements = Positions;
+		Stress.Pass(Positions, Settings.KConstant, StressPass, Settings.StressIterations, Settings.StressEpsilon);
+		StressPass = std::min(StressPass + 1, std::max(Settings.StressIterations, 1));
+
+		float MaxSquared = 0.f;
+		float MaxDriftSquared = 0.f;
+		double SumDriftSquared = 0.0;
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			const FVec3 PreviousDisplacement = Displacements.Get(v);
+			const FVec3 Displacement = Positions.Get(v) - Movements.Get(v);
+			Displacements.Set(v, Displacement);
+			MaxSquared = std::max(MaxSquared, Displacement.SizeSquared());
+
+			const float DriftSquared = ((Displacement + PreviousDisplacement) * 0.5f).SizeSquared();
+			MaxDriftSquared = std::max(MaxDriftSquared, DriftSquared);
+			SumDriftSquared += DriftSquared;
+		}
+
+		MaxDisplacement = std::sqrt(MaxSquared);
+		MaxDrift = std::sqrt(MaxDriftSquared);
+		Energy = static_cast<float>(SumDriftSquared);
+		NumQuietIterations = MaxDrift < Settings.ConvergenceThreshold ? NumQuietIterations + 1 : 0;
+
+		// Computing the distances is reported as repulsion, the pass itself as apply
+		LastStepTimings.Repulsion = SecondsBetween(BuildStart, PassStart);
+		LastStepTimings.Attraction = 0.0;
+		LastStepTimings.Apply = SecondsBetween(PassStart, FClock::now());
+	}
+}
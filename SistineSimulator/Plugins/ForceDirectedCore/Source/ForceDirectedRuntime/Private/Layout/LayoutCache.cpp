@@ -0,0 +1,218 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Layout/LayoutCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ForceDirected
+{
+	namespace
+	{
+		constexpr uint64_t GFnv_Prime = 1099511628211ull;
+
+		constexpr uint32_t GCache_Magic = 0x4c464443; // "CDFL"
+		constexpr uint32_t GCache_Version = 1;
+
+		size_t GetPositionBytes(const FLayoutBuffers& Positions)
+		{
+			return static_cast<size_t>(Positions.Num()) * 3 * sizeof(float);
+		}
+
+		template<typename T>
+		void WriteValue(std::vector<uint8_t>& Bytes, const T& Value)
+		{
+			const size_t Offset = Bytes.size();
+			Bytes.resize(Offset + sizeof(T));
+			std::memcpy(Bytes.data() + Offset, &Value, sizeof(T));
+		}
+
+		void WriteFloats(std::vector<uint8_t>& Bytes, const std::vector<float>& Values)
+		{
+			const size_t Offset = Bytes.size();
+			Bytes.resize(Offset + Values.size() * sizeof(float));
+			std::memcpy(Bytes.data() + Offset, Values.data(), Values.size() * sizeof(float));
+		}
+
+		// Bounds checked cursor over a blob
+		struct FByteReader
+		{
+			const std::vector<uint8_t>& Bytes;
+			size_t Offset = 0;
+
+			template<typename T>
+			bool Read(T& OutValue)
+			{
+				if (Bytes.size() - Offset < sizeof(T))
+					return false;
+				std::memcpy(&OutValue, Bytes.data() + Offset, sizeof(T));
+				Offset += sizeof(T);
+				return true;
+			}
+
+			bool ReadFloats(std::vector<float>& OutValues, const int32_t Num)
+			{
+				const size_t Size = static_cast<size_t>(Num) * sizeof(float);
+				if (Bytes.size() - Offset < Size)
+					return false;
+				OutValues.resize(Num);
+				std::memcpy(OutValues.data(), Bytes.data() + Offset, Size);
+				Offset += Size;
+				return true;
+			}
+		};
+	}
+
+	void FLayoutHasher::AddBytes(const void* Data, const size_t Size)
+	{
+		const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+		for (size_t i = 0; i < Size; ++i)
+		{
+			Hash = (Hash ^ Bytes[i]) * GFnv_Prime;
+		}
+	}
+
+	void FLayoutHasher::AddString(const std::string_view Value)
+	{
+		AddInt(static_cast<int64_t>(Value.size()));
+		AddBytes(Value.data(), Value.size());
+	}
+
+	uint64_t HashGraphTopology(const FLayoutGraph& Graph, const std::vector<int32_t>& CanonicalIndex,
+	                           const uint64_t Seed)
+	{
+		const int32_t NumNodes = Graph.GetNumNodes();
+		FLayoutHasher Hasher(Seed);
+		Hasher.AddInt(NumNodes);
+
+		// Renumber, then sort so the hash does not depend on the original numbering. Without a full
+		// renumbering the graph's own indices are used.
+		const bool bRenumber = static_cast<int32_t>(CanonicalIndex.size()) == NumNodes;
+		std::vector<FEdge> Edges;
+		Edges.reserve(Graph.GetEdges().size());
+		for (const FEdge& Edge : Graph.GetEdges())
+		{
+			const int32_t A = bRenumber ? CanonicalIndex[Edge.A] : Edge.A;
+			const int32_t B = bRenumber ? CanonicalIndex[Edge.B] : Edge.B;
+			Edges.push_back({std::min(A, B), std::max(A, B)});
+		}
+		std::sort(Edges.begin(), Edges.end(), [](const FEdge& Lhs, const FEdge& Rhs)
+		{
+			return Lhs.A != Rhs.A ? Lhs.A < Rhs.A : Lhs.B < Rhs.B;
+		});
+
+		Hasher.AddInt(static_cast<int64_t>(Edges.size()));
+		for (const FEdge& Edge : Edges)
+		{
+			Hasher.AddInt(Edge.A);
+			Hasher.AddInt(Edge.B);
+		}
+		return Hasher.Get();
+	}
+
+	bool FLayoutCache::Find(const uint64_t Key, const int32_t NumNodes, FLayoutBuffers& OutPositions)
+	{
+		const auto Entry = Entries.find(Key);
+		if (Entry == Entries.end() || Entry->second.Positions.Num() != NumNodes)
+			return false;
+
+		Recency.splice(Recency.begin(), Recency, Entry->second.Use);
+		OutPositions = Entry->second.Positions;
+		return true;
+	}
+
+	void FLayoutCache::Store(const uint64_t Key, const FLayoutBuffers& Positions)
+	{
+		Remove(Key);
+		const size_t Size = GetPositionBytes(Positions);
+		if (Size > MaxBytes)
+			return;
+
+		Recency.push_front(Key);
+		Entries[Key] = {Positions, Recency.begin()};
+		NumBytes += Size;
+		EvictToFit();
+	}
+
+	bool FLayoutCache::Remove(const uint64_t Key)
+	{
+		const auto Entry = Entries.find(Key);
+		if (Entry == Entries.end())
+			return false;
+
+		NumBytes -= GetPositionBytes(Entry->second.Positions);
+		Recency.erase(Entry->second.Use);
+		Entries.erase(Entry);
+		return true;
+	}
+
+	void FLayoutCache::Reset()
+	{
+		Entries.clear();
+		Recency.clear();
+		NumBytes = 0;
+	}
+
+	void FLayoutCache::SetMaxBytes(const size_t InMaxBytes)
+	{
+		MaxBytes = InMaxBytes;
+		EvictToFit();
+	}
+
+	void FLayoutCache::EvictToFit()
+	{
+		while (NumBytes > MaxBytes && !Recency.empty())
+		{
+			Remove(Recency.back());
+		}
+	}
+
+	void FLayoutCache::Save(std::vector<uint8_t>& OutBytes) const
+	{
+		OutBytes.clear();
+		WriteValue(OutBytes, GCache_Magic);
+		WriteValue(OutBytes, GCache_Version);
+		WriteValue(OutBytes, static_cast<uint32_t>(Entries.size()));
+
+		for (auto Use = Recency.rbegin(); Use != Recency.rend(); ++Use)
+		{
+			const uint64_t Key = *Use;
+			const FLayoutBuffers& Positions = Entries.at(Key).Positions;
+			WriteValue(OutBytes, Key);
+			WriteValue(OutBytes, static_cast<int32_t>(Positions.Num()));
+			WriteFloats(OutBytes, Positions.X);
+			WriteFloats(OutBytes, Positions.Y);
+			WriteFloats(OutBytes, Positions.Z);
+		}
+	}
+
+	bool FLayoutCache::Load(const std::vector<uint8_t>& Bytes)
+	{
+		Reset();
+
+		FByteReader Reader{Bytes};
+		uint32_t Magic = 0;
+		uint32_t Version = 0;
+		uint32_t NumEntries = 0;
+		if (!Reader.Read(Magic) || Magic != GCache_Magic || !Reader.Read(Version) || Version != GCache_Version
+			|| !Reader.Read(NumEntries))
+			return false;
+
+		for (uint32_t i = 0; i < NumEntries; ++i)
+		{
+			uint64_t Key = 0;
+			int32_t NumNodes = 0;
+			FLayoutBuffers Positions;
+			if (!Reader.Read(Key) || !Reader.Read(NumNodes) || NumNodes < 0
+				|| !Reader.ReadFloats(Positions.X, NumNodes)
+				|| !Reader.ReadFloats(Positions.Y, NumNodes)
+				|| !Reader.ReadFloats(Positions.Z, NumNodes))
+			{
+				Reset();
+				return false;
+			}
+			Store(Key, Positions);
+		}
+		return true;
+	}
+}
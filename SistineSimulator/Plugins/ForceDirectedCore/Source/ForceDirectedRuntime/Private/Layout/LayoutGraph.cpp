@@ -0,0 +1,69 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Layout/LayoutGraph.h"
+
+#include <algorithm>
+
+namespace ForceDirected
+{
+	void FLayoutGraph::Build(const int32_t InNumNodes, const std::vector<FEdge>& InEdges)
+	{
+		NumNodes = std::max(InNumNodes, 0);
+
+		Edges.clear();
+		Edges.reserve(InEdges.size());
+		for (const FEdge& Edge : InEdges)
+		{
+			if (Edge.A >= 0 && Edge.A < NumNodes && Edge.B >= 0 && Edge.B < NumNodes && Edge.A != Edge.B)
+			{
+				Edges.push_back({std::min(Edge.A, Edge.B), std::max(Edge.A, Edge.B)});
+			}
+		}
+
+		std::sort(Edges.begin(), Edges.end(), [](const FEdge& Lhs, const FEdge& Rhs)
+		{
+			return Lhs.A != Rhs.A ? Lhs.A < Rhs.A : Lhs.B < Rhs.B;
+		});
+		Edges.erase(std::unique(Edges.begin(), Edges.end(), [](const FEdge& Lhs, const FEdge& Rhs)
+		{
+			return Lhs.A == Rhs.A && Lhs.B == Rhs.B;
+		}), Edges.end());
+		Edges.shrink_to_fit();
+
+		// Degree count, then exclusive prefix sum into offsets
+		Offsets.assign(static_cast<size_t>(NumNodes) + 1, 0);
+		for (const FEdge& Edge : Edges)
+		{
+			++Offsets[Edge.A + 1];
+			++Offsets[Edge.B + 1];
+		}
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			Offsets[v + 1] += Offsets[v];
+		}
+
+		// Edges are sorted by (A, B), so every node receives its smaller neighbors first and its larger
+		// neighbors after, both in ascending order: each row comes out sorted without an extra pass
+		Neighbors.assign(Edges.size() * 2, InvalidIndex);
+		std::vector<int32_t> Cursor(Offsets.begin(), Offsets.end() - 1);
+		for (const FEdge& Edge : Edges)
+		{
+			Neighbors[Cursor[Edge.A]++] = Edge.B;
+			Neighbors[Cursor[Edge.B]++] = Edge.A;
+		}
+	}
+
+	void FLayoutGraph::Reset()
+	{
+		NumNodes = 0;
+		Offsets.clear();
+		Neighbors.clear();
+		Edges.clear();
+	}
+
+	size_t FLayoutGraph::GetAllocatedSize() const
+	{
+		return Offsets.capacity() * sizeof(int32_t) + Neighbors.capacity() * sizeof(int32_t)
+			+ Edges.capacity() * sizeof(FEdge);
+	}
+}
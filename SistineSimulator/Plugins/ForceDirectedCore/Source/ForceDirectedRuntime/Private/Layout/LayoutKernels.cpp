@@ -0,0 +1,237 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Layout/LayoutKernels.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define FORCEDIRECTED_SSE 1
+#else
+#define FORCEDIRECTED_SSE 0
+#endif
+
+// 64-bit ARM only, 32-bit NEON has no vector division
+#if !FORCEDIRECTED_SSE && (defined(__aarch64__) || defined(_M_ARM64))
+#include <arm_neon.h>
+#define FORCEDIRECTED_NEON 1
+#else
+#define FORCEDIRECTED_NEON 0
+#endif
+
+namespace ForceDirected
+{
+	namespace
+	{
+		// Pairs closer than this are considered coincident and do not repulse
+		constexpr float GKernel_Min_Distance = 1.e-4f;
+
+		// Repulsion on node v from nodes [Begin, NumNodes), for the nodes that don't fill a whole vector register
+		void AddRepulsionRemainder(const float* PX, const float* PY, const float* PZ, const int32_t v,
+		                           const int32_t Begin, const int32_t NumNodes, const float KSquared,
+		                           const float MaxDistance, float& FX, float& FY, float& FZ)
+		{
+			for (int32_t u = Begin; u < NumNodes; ++u)
+			{
+				const float DX = PX[v] - PX[u];
+				const float DY = PY[v] - PY[u];
+				const float DZ = PZ[v] - PZ[u];
+				const float DistSq = DX * DX + DY * DY + DZ * DZ;
+				if (DistSq < GKernel_Min_Distance * GKernel_Min_Distance || DistSq > MaxDistance * MaxDistance)
+					continue;
+
+				const float Scale = KSquared / DistSq;
+				FX += DX * Scale;
+				FY += DY * Scale;
+				FZ += DZ * Scale;
+			}
+		}
+	}
+
+	void FLayoutKernels::RepulsionScalar(const FLayoutBuffers& Positions, const int32_t Begin, const int32_t End,
+	                                     const float KSquared, const float MaxDistance, FLayoutBuffers& OutForces)
+	{
+		const int32_t NumNodes = Positions.Num();
+		const float* PX = Positions.X.data();
+		const float* PY = Positions.Y.data();
+		const float* PZ = Positions.Z.data();
+
+		for (int32_t v = Begin; v < End; ++v)
+		{
+			float FX = 0.f, FY = 0.f, FZ = 0.f;
+			for (int32_t u = 0; u < NumNodes; ++u)
+			{
+				const float DX = PX[v] - PX[u];
+				const float DY = PY[v] - PY[u];
+				const float DZ = PZ[v] - PZ[u];
+				const float Dist = std::sqrt(DX * DX + DY * DY + DZ * DZ);
+
+				// Also skips u == v
+				if (Dist < GKernel_Min_Distance || Dist > MaxDistance)
+					continue;
+
+				// Direction * (K^2 / Dist)
+				const float Scale = KSquared / (Dist * Dist);
+				FX += DX * Scale;
+				FY += DY * Scale;
+				FZ += DZ * Scale;
+			}
+			OutForces.X[v] += FX;
+			OutForces.Y[v] += FY;
+			OutForces.Z[v] += FZ;
+		}
+	}
+
+	void FLayoutKernels::RepulsionSimd(const FLayoutBuffers& Positions, const int32_t Begin, const int32_t End,
+	                                   const float KSquared, const float MaxDistance, FLayoutBuffers& OutForces)
+	{
+#if FORCEDIRECTED_SSE
+		const int32_t NumNodes = Positions.Num();
+		const int32_t NumVectorized = NumNodes & ~3;
+		const float* PX = Positions.X.data();
+		const float* PY = Positions.Y.data();
+		const float* PZ = Positions.Z.data();
+
+		const __m128 KSq = _mm_set1_ps(KSquared);
+		const __m128 MinDistSq = _mm_set1_ps(GKernel_Min_Distance * GKernel_Min_Distance);
+		const __m128 MaxDistSq = _mm_set1_ps(MaxDistance * MaxDistance);
+
+		for (int32_t v = Begin; v < End; ++v)
+		{
+			const __m128 VX = _mm_set1_ps(PX[v]);
+			const __m128 VY = _mm_set1_ps(PY[v]);
+			const __m128 VZ = _mm_set1_ps(PZ[v]);
+			__m128 AccX = _mm_setzero_ps();
+			__m128 AccY = _mm_setzero_ps();
+			__m128 AccZ = _mm_setzero_ps();
+
+			for (int32_t u = 0; u < NumVectorized; u += 4)
+			{
+				const __m128 DX = _mm_sub_ps(VX, _mm_loadu_ps(PX + u));
+				const __m128 DY = _mm_sub_ps(VY, _mm_loadu_ps(PY + u));
+				const __m128 DZ = _mm_sub_ps(VZ, _mm_loadu_ps(PZ + u));
+				const __m128 DistSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(DX, DX), _mm_mul_ps(DY, DY)),
+				                                 _mm_mul_ps(DZ, DZ));
+
+				// Masked-out lanes (self, coincident, beyond cutoff) may divide by zero, the mask clears them
+				const __m128 InRange = _mm_and_ps(_mm_cmpge_ps(DistSq, MinDistSq), _mm_cmple_ps(DistSq, MaxDistSq));
+				const __m128 Scale = _mm_and_ps(_mm_div_ps(KSq, DistSq), InRange);
+
+				AccX = _mm_add_ps(AccX, _mm_mul_ps(DX, Scale));
+				AccY = _mm_add_ps(AccY, _mm_mul_ps(DY, Scale));
+				AccZ = _mm_add_ps(AccZ, _mm_mul_ps(DZ, Scale));
+			}
+
+			alignas(16) float Lanes[3][4];
+			_mm_store_ps(Lanes[0], AccX);
+			_mm_store_ps(Lanes[1], AccY);
+			_mm_store_ps(Lanes[2], AccZ);
+			float FX = Lanes[0][0] + Lanes[0][1] + Lanes[0][2] + Lanes[0][3];
+			float FY = Lanes[1][0] + Lanes[1][1] + Lanes[1][2] + Lanes[1][3];
+			float FZ = Lanes[2][0] + Lanes[2][1] + Lanes[2][2] + Lanes[2][3];
+
+			AddRepulsionRemainder(PX, PY, PZ, v, NumVectorized, NumNodes, KSquared, MaxDistance, FX, FY, FZ);
+
+			OutForces.X[v] += FX;
+			OutForces.Y[v] += FY;
+			OutForces.Z[v] += FZ;
+		}
+#elif FORCEDIRECTED_NEON
+		const int32_t NumNodes = Positions.Num();
+		const int32_t NumVectorized = NumNodes & ~3;
+		const float* PX = Positions.X.data();
+		const float* PY = Positions.Y.data();
+		const float* PZ = Positions.Z.data();
+
+		const float32x4_t KSq = vdupq_n_f32(KSquared);
+		const float32x4_t MinDistSq = vdupq_n_f32(GKernel_Min_Distance * GKernel_Min_Distance);
+		const float32x4_t MaxDistSq = vdupq_n_f32(MaxDistance * MaxDistance);
+
+		for (int32_t v = Begin; v < End; ++v)
+		{
+			const float32x4_t VX = vdupq_n_f32(PX[v]);
+			const float32x4_t VY = vdupq_n_f32(PY[v]);
+			const float32x4_t VZ = vdupq_n_f32(PZ[v]);
+			float32x4_t AccX = vdupq_n_f32(0.f);
+			float32x4_t AccY = vdupq_n_f32(0.f);
+			float32x4_t AccZ = vdupq_n_f32(0.f);
+
+			for (int32_t u = 0; u < NumVectorized; u += 4)
+			{
+				const float32x4_t DX = vsubq_f32(VX, vld1q_f32(PX + u));
+				const float32x4_t DY = vsubq_f32(VY, vld1q_f32(PY + u));
+				const float32x4_t DZ = vsubq_f32(VZ, vld1q_f32(PZ + u));
+				const float32x4_t DistSq = vaddq_f32(vaddq_f32(vmulq_f32(DX, DX), vmulq_f32(DY, DY)),
+				                                     vmulq_f32(DZ, DZ));
+
+				// Same masking as the SSE path, the division of masked-out lanes is discarded
+				const uint32x4_t InRange = vandq_u32(vcgeq_f32(DistSq, MinDistSq), vcleq_f32(DistSq, MaxDistSq));
+				const float32x4_t Scale = vreinterpretq_f32_u32(
+					vandq_u32(vreinterpretq_u32_f32(vdivq_f32(KSq, DistSq)), InRange));
+
+				AccX = vaddq_f32(AccX, vmulq_f32(DX, Scale));
+				AccY = vaddq_f32(AccY, vmulq_f32(DY, Scale));
+				AccZ = vaddq_f32(AccZ, vmulq_f32(DZ, Scale));
+			}
+
+			float FX = vaddvq_f32(AccX);
+			float FY = vaddvq_f32(AccY);
+			float FZ = vaddvq_f32(AccZ);
+			AddRepulsionRemainder(PX, PY, PZ, v, NumVectorized, NumNodes, KSquared, MaxDistance, FX, FY, FZ);
+
+			OutForces.X[v] += FX;
+			OutForces.Y[v] += FY;
+			OutForces.Z[v] += FZ;
+		}
+#else
+		RepulsionScalar(Positions, Begin, End, KSquared, MaxDistance, OutForces);
+#endif
+	}
+
+	void FLayoutKernels::Attraction(const FLayoutBuffers& Positions, const FEdge* Edges, const int32_t Begin,
+	                                const int32_t End, const float KConstant, FLayoutBuffers& OutForces)
+	{
+		for (int32_t e = Begin; e < End; ++e)
+		{
+			const FEdge& Edge = Edges[e];
+			const FVec3 Delta = Positions.Get(Edge.A) - Positions.Get(Edge.B);
+			const float Distance = Delta.Size();
+			if (Distance < GKernel_Min_Distance)
+				continue;
+
+			// Direction * (Distance^2 / K)
+			const FVec3 Attraction = Delta * (Distance / KConstant);
+			OutForces.Add(Edge.A, -Attraction);
+			OutForces.Add(Edge.B, Attraction);
+		}
+	}
+
+	float FLayoutKernels::CompareRepulsionKernels(const FLayoutBuffers& Positions, const float KSquared,
+	                                              const float MaxDistance)
+	{
+		const int32_t NumNodes = Positions.Num();
+		FLayoutBuffers Scalar, Simd;
+		Scalar.SetNumZeroed(NumNodes);
+		Simd.SetNumZeroed(NumNodes);
+
+		RepulsionScalar(Positions, 0, NumNodes, KSquared, MaxDistance, Scalar);
+		RepulsionSimd(Positions, 0, NumNodes, KSquared, MaxDistance, Simd);
+
+		float MaxError = 0.f;
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			const FVec3 Reference = Scalar.Get(v);
+			const float Error = (Simd.Get(v) - Reference).Size() / std::max(Reference.Size(), 1.f);
+			MaxError = std::max(MaxError, Error);
+		}
+		return MaxError;
+	}
+
+	bool FLayoutKernels::IsSimdAvailable()
+	{
+		return FORCEDIRECTED_SSE != 0 || FORCEDIRECTED_NEON != 0;
+	}
+}
+
+#undef FORCEDIRECTED_SSE
+#undef FORCEDIRECTED_NEON
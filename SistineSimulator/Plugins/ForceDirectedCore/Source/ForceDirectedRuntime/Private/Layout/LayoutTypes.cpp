@@ -0,0 +1,44 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Layout/LayoutTypes.h"
+
+#include <thread>
+
+namespace ForceDirected
+{
+	void RunTasks(const FParallelForFunction& ParallelFor, const int32_t NumTasks,
+	              const std::function<void(int32_t)>& Body)
+	{
+		if (!ParallelFor || NumTasks <= 1)
+		{
+			for (int32_t Task = 0; Task < NumTasks; ++Task)
+			{
+				Body(Task);
+			}
+			return;
+		}
+		ParallelFor(NumTasks, Body);
+	}
+
+	FParallelForFunction MakeThreadParallelFor()
+	{
+		return [](const int32_t NumTasks, const std::function<void(int32_t)>& Body)
+		{
+			// The calling thread takes task 0
+			std::vector<std::thread> Workers;
+			Workers.reserve(NumTasks > 0 ? NumTasks - 1 : 0);
+			for (int32_t Task = 1; Task < NumTasks; ++Task)
+			{
+				Workers.emplace_back(Body, Task);
+			}
+			if (NumTasks > 0)
+			{
+				Body(0);
+			}
+			for (std::thread& Worker : Workers)
+			{
+				Worker.join();
+			}
+		};
+	}
+}
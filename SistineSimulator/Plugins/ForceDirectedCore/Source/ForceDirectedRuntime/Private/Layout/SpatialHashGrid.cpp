@@ -0,0 +1,184 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Layout/SpatialHashGrid.h"
+
+#include <algorithm>
+
+namespace ForceDirected
+{
+	namespace
+	{
+		// Pairs closer than this are considered coincident and do not repulse
+		constexpr float GGrid_Min_Distance = 1.e-4f;
+
+		uint64_t HashCellKey(const int64_t Key)
+		{
+			// Fibonacci hashing, the high bits are the well mixed ones
+			return static_cast<uint64_t>(Key) * 0x9E3779B97F4A7C15ull;
+		}
+	}
+
+	int32_t FSpatialHashGrid::ToCell(const float Coordinate) const
+	{
+		const float Cell = std::floor(Coordinate / CellSize);
+		const float Limit = static_cast<float>(CoordinateBias - 1);
+		return static_cast<int32_t>(std::clamp(Cell, -Limit, Limit));
+	}
+
+	int64_t FSpatialHashGrid::MakeKey(const int32_t CellX, const int32_t CellY, const int32_t CellZ)
+	{
+		return (static_cast<int64_t>(CellX + CoordinateBias) << (2 * CoordinateBits))
+			| (static_cast<int64_t>(CellY + CoordinateBias) << CoordinateBits)
+			| static_cast<int64_t>(CellZ + CoordinateBias);
+	}
+
+	int32_t FSpatialHashGrid::FindSlot(const int64_t Key) const
+	{
+		const uint64_t Mask = Slots.size() - 1;
+		for (uint64_t Slot = (HashCellKey(Key) >> 32) & Mask;; Slot = (Slot + 1) & Mask)
+		{
+			if (Slots[Slot].Key == Key)
+				return static_cast<int32_t>(Slot);
+			if (Slots[Slot].Key == EmptyKey)
+				return InvalidIndex;
+		}
+	}
+
+	int32_t FSpatialHashGrid::FindOrAddSlot(const int64_t Key)
+	{
+		const uint64_t Mask = Slots.size() - 1;
+		for (uint64_t Slot = (HashCellKey(Key) >> 32) & Mask;; Slot = (Slot + 1) & Mask)
+		{
+			if (Slots[Slot].Key == Key)
+				return static_cast<int32_t>(Slot);
+			if (Slots[Slot].Key == EmptyKey)
+			{
+				Slots[Slot].Key = Key;
+				++NumOccupiedCells;
+				return static_cast<int32_t>(Slot);
+			}
+		}
+	}
+
+	void FSpatialHashGrid::Build(const FLayoutBuffers& InPositions, const float InCellSize)
+	{
+		const int32_t NumNodes = InPositions.Num();
+		CellSize = std::max(InCellSize, GGrid_Min_Distance);
+		NumOccupiedCells = 0;
+
+		// At most one cell per node, keep the load factor at or below one half
+		size_t NumSlots = 16;
+		while (NumSlots < 2 * static_cast<size_t>(NumNodes))
+		{
+			NumSlots *= 2;
+		}
+		Slots.assign(NumSlots, FSlot());
+
+		// Count the nodes per cell, remembering every node's slot in SortedIndices for now
+		SortedIndices.resize(NumNodes);
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			const FVec3 Position = InPositions.Get(v);
+			const int32_t Slot = FindOrAddSlot(MakeKey(ToCell(Position.X), ToCell(Position.Y), ToCell(Position.Z)));
+			++Slots[Slot].End;
+			SortedIndices[v] = Slot;
+		}
+
+		// Turn the counts into ranges
+		int32_t Offset = 0;
+		for (FSlot& Slot : Slots)
+		{
+			if (Slot.Key == EmptyKey)
+				continue;
+			Slot.Begin = Offset;
+			Offset += Slot.End;
+			Slot.End = Slot.Begin;
+		}
+
+		// Scatter the nodes into their cell ranges, End doubling as the insertion cursor
+		SortedNodes.resize(NumNodes);
+		SortedPositions.SetNumZeroed(NumNodes);
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			const int32_t Index = Slots[SortedIndices[v]].End++;
+			SortedIndices[v] = Index;
+			SortedNodes[Index] = v;
+			SortedPositions.Set(Index, InPositions.Get(v));
+		}
+	}
+
+	FVec3 FSpatialHashGrid::ComputeRepulsion(const int32_t NodeIndex, const float KSquared) const
+	{
+		if (NodeIndex < 0 || NodeIndex >= static_cast<int32_t>(SortedIndices.size()))
+			return FVec3();
+
+		return ComputeRepulsionAt(SortedPositions.Get(SortedIndices[NodeIndex]), KSquared);
+	}
+
+	FVec3 FSpatialHashGrid::ComputeRepulsionAt(const FVec3& Position, const float KSquared) const
+	{
+		FVec3 Force;
+		if (Slots.empty())
+			return Force;
+
+		const int32_t CellX = ToCell(Position.X);
+		const int32_t CellY = ToCell(Position.Y);
+		const int32_t CellZ = ToCell(Position.Z);
+
+		const float MaxDistanceSquared = CellSize * CellSize;
+		const float MinDistanceSquared = GGrid_Min_Distance * GGrid_Min_Distance;
+		const float* SX = SortedPositions.X.data();
+		const float* SY = SortedPositions.Y.data();
+		const float* SZ = SortedPositions.Z.data();
+
+		for (int32_t DX = -1; DX <= 1; ++DX)
+		{
+			for (int32_t DY = -1; DY <= 1; ++DY)
+			{
+				for (int32_t DZ = -1; DZ <= 1; ++DZ)
+				{
+					const int32_t Slot = FindSlot(MakeKey(CellX + DX, CellY + DY, CellZ + DZ));
+					if (Slot == InvalidIndex)
+						continue;
+
+					const FSlot& Range = Slots[Slot];
+					for (int32_t i = Range.Begin; i < Range.End; ++i)
+					{
+						const float X = Position.X - SX[i];
+						const float Y = Position.Y - SY[i];
+						const float Z = Position.Z - SZ[i];
+						const float DistSquared = X * X + Y * Y + Z * Z;
+
+						// Also skips the node itself
+						if (DistSquared < MinDistanceSquared || DistSquared > MaxDistanceSquared)
+							continue;
+
+						// Direction * (K^2 / Dist)
+						const float Scale = KSquared / DistSquared;
+						Force += FVec3(X * Scale, Y * Scale, Z * Scale);
+					}
+				}
+			}
+		}
+
+		return Force;
+	}
+
+	size_t FSpatialHashGrid::GetAllocatedSize() const
+	{
+		return Slots.capacity() * sizeof(FSlot)
+			+ SortedNodes.capacity() * sizeof(int32_t)
+			+ SortedIndices.capacity() * sizeof(int32_t)
+			+ 3 * SortedPositions.X.capacity() * sizeof(float);
+	}
+
+	void FSpatialHashGrid::Reset()
+	{
+		CellSize = 0.f;
+		NumOccupiedCells = 0;
+		Slots.clear();
+		SortedNodes.clear();
+		SortedPositions.Reset();
+		SortedIndices.clear();
+	}
+}
@@ -0,0 +1,271 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Layout/StressMajorization.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace ForceDirected
+{
+	namespace
+	{
+		// Pairs closer than this have no direction to move along and are pushed apart along a random one
+		constexpr float GStress_Min_Distance = 1.e-4f;
+
+		constexpr uint32_t GStress_Seed = 0x5EED5u;
+
+		// Hop distances from Source to every node, -1 where unreachable. Queue is scratch of NumNodes entries.
+		void HopDistancesFrom(const FLayoutGraph& Graph, const int32_t Source, std::vector<int32_t>& OutDistances,
+		                      std::vector<int32_t>& Queue)
+		{
+			std::fill(OutDistances.begin(), OutDistances.end(), -1);
+			OutDistances[Source] = 0;
+			Queue[0] = Source;
+			for (int32_t Head = 0, Tail = 1; Head < Tail; ++Head)
+			{
+				const int32_t v = Queue[Head];
+				for (const int32_t* u = Graph.NeighborsBegin(v); u != Graph.NeighborsEnd(v); ++u)
+				{
+					if (OutDistances[*u] < 0)
+					{
+						OutDistances[*u] = OutDistances[v] + 1;
+						Queue[Tail++] = *u;
+					}
+				}
+			}
+		}
+	}
+
+	void FStressMajorization::Build(const FLayoutGraph& Graph, const int32_t MaxAllPairsNodes, const int32_t NumPivots,
+	                                const FParallelForFunction& ParallelFor, const int32_t NumTasks)
+	{
+		Reset();
+		Rng.seed(GStress_Seed);
+
+		const int32_t NumNodes = Graph.GetNumNodes();
+		const int32_t Tasks = std::clamp(NumTasks, 1, std::max(NumNodes, 1));
+		bSparse = NumNodes > MaxAllPairsNodes && NumPivots > 0;
+		if (bSparse)
+		{
+			BuildSparse(Graph, NumPivots, ParallelFor, Tasks);
+		}
+		else
+		{
+			BuildAllPairs(Graph, ParallelFor, Tasks);
+		}
+
+		// Other components sit one hop beyond the farthest reachable node, then distances turn into weights
+		float MaxDistance = 0.f;
+		for (const FTerm& Term : Terms)
+		{
+			MaxDistance = std::max(MaxDistance, Term.Distance);
+		}
+		MinWeight = 0.f;
+		MaxWeight = 0.f;
+		for (FTerm& Term : Terms)
+		{
+			if (Term.Distance < 0.f)
+			{
+				Term.Distance = MaxDistance + 1.f;
+			}
+			Term.Weight /= Term.Distance * Term.Distance;
+			MinWeight = MinWeight > 0.f ? std::min(MinWeight, Term.Weight) : Term.Weight;
+			MaxWeight = std::max(MaxWeight, Term.Weight);
+		}
+		bBuilt = true;
+	}
+
+	void FStressMajorization::BuildAllPairs(const FLayoutGraph& Graph, const FParallelForFunction& ParallelFor,
+	                                        const int32_t NumTasks)
+	{
+		// One BFS per node, each task owns a range of sources and its own buffers
+		const int32_t NumNodes = Graph.GetNumNodes();
+		std::vector<std::vector<FTerm>> TaskTerms(NumTasks);
+		RunTasks(ParallelFor, NumTasks, [&Graph, &TaskTerms, NumNodes, NumTasks](const int32_t Task)
+		{
+			const int32_t Begin = static_cast<int32_t>(static_cast<int64_t>(NumNodes) * Task / NumTasks);
+			const int32_t End = static_cast<int32_t>(static_cast<int64_t>(NumNodes) * (Task + 1) / NumTasks);
+			std::vector<int32_t> Distances(NumNodes), Queue(NumNodes);
+			std::vector<FTerm>& Out = TaskTerms[Task];
+			for (int32_t i = Begin; i < End; ++i)
+			{
+				HopDistancesFrom(Graph, i, Distances, Queue);
+				for (int32_t j = i + 1; j < NumNodes; ++j)
+				{
+					Out.push_back({i, j, static_cast<float>(Distances[j]), 1.f, true});
+				}
+			}
+		});
+
+		// Concatenated in source order, so the result doesn't depend on the number of tasks
+		Terms.reserve(static_cast<size_t>(NumNodes) * std::max(NumNodes - 1, 0) / 2);
+		for (const std::vector<FTerm>& Out : TaskTerms)
+		{
+			Terms.insert(Terms.end(), Out.begin(), Out.end());
+		}
+	}
+
+	void FStressMajorization::BuildSparse(const FLayoutGraph& Graph, const int32_t NumPivots,
+	                                      const FParallelForFunction& ParallelFor, const int32_t NumTasks)
+	{
+		const int32_t NumNodes = Graph.GetNumNodes();
+
+		// Max-min pivots: every next one is the node farthest from all pivots so far. Unreachable nodes count as
+		// infinitely far, so every component gets a pivot before any component gets a second one.
+		std::vector<int32_t> Pivots;
+		std::vector<std::vector<int32_t>> PivotDistances;
+		std::vector<int32_t> NearestPivot(NumNodes, InvalidIndex);
+		std::vector<int32_t> NearestDistance(NumNodes, INT_MAX);
+		std::vector<int32_t> Queue(NumNodes);
+		for (int32_t Next = 0; static_cast<int32_t>(Pivots.size()) < std::min(NumPivots, NumNodes);)
+		{
+			const int32_t Pivot = static_cast<int32_t>(Pivots.size());
+			Pivots.push_back(Next);
+			std::vector<int32_t>& Distances = PivotDistances.emplace_back(NumNodes);
+			HopDistancesFrom(Graph, Next, Distances, Queue);
+
+			for (int32_t v = 0; v < NumNodes; ++v)
+			{
+				if (Distances[v] >= 0 && Distances[v] < NearestDistance[v])
+				{
+					NearestDistance[v] = Distances[v];
+					NearestPivot[v] = Pivot;
+				}
+			}
+
+			Next = static_cast<int32_t>(std::max_element(NearestDistance.begin(), NearestDistance.end())
+				- NearestDistance.begin());
+			if (NearestDistance[Next] == 0)
+				break;
+		}
+
+		// Distances of the nodes each pivot is nearest to, sorted, to count how many a pivot term stands in for.
+		// With more components than pivots some nodes reach none; they belong to no region and only get
+		// disconnected terms to every pivot below, plus their edges.
+		std::vector<std::vector<int32_t>> Regions(Pivots.size());
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			if (NearestPivot[v] != InvalidIndex)
+			{
+				Regions[NearestPivot[v]].push_back(NearestDistance[v]);
+			}
+		}
+		for (std::vector<int32_t>& Region : Regions)
+		{
+			std::sort(Region.begin(), Region.end());
+		}
+
+		// Edges are exact terms
+		for (const FEdge& Edge : Graph.GetEdges())
+		{
+			Terms.push_back({Edge.A, Edge.B, 1.f, 1.f, true});
+		}
+
+		// Every node against every pivot, weighted by the nodes of the pivot's region at most half as far from
+		// the pivot as the node is, which the pivot represents for it
+		std::vector<std::vector<FTerm>> TaskTerms(NumTasks);
+		RunTasks(ParallelFor, NumTasks, [&](const int32_t Task)
+		{
+			const int32_t Begin = static_cast<int32_t>(static_cast<int64_t>(NumNodes) * Task / NumTasks);
+			const int32_t End = static_cast<int32_t>(static_cast<int64_t>(NumNodes) * (Task + 1) / NumTasks);
+			std::vector<FTerm>& Out = TaskTerms[Task];
+			for (int32_t i = Begin; i < End; ++i)
+			{
+				for (size_t p = 0; p < Pivots.size(); ++p)
+				{
+					if (Pivots[p] == i)
+						continue;
+
+					const int32_t Distance = PivotDistances[p][i];
+					if (Distance < 0)
+					{
+						Out.push_back({i, Pivots[p], -1.f, 1.f, false});
+						continue;
+					}
+
+					const std::vector<int32_t>& Region = Regions[p];
+					const int32_t NumRepresented = static_cast<int32_t>(
+						std::upper_bound(Region.begin(), Region.end(), Distance / 2) - Region.begin());
+					Out.push_back({
+						i, Pivots[p], static_cast<float>(Distance), static_cast<float>(std::max(NumRepresented, 1)),
+						false
+					});
+				}
+			}
+		});
+		for (const std::vector<FTerm>& Out : TaskTerms)
+		{
+			Terms.insert(Terms.end(), Out.begin(), Out.end());
+		}
+	}
+
+	void FStressMajorization::Reset()
+	{
+		Terms.clear();
+		MinWeight = 1.f;
+		MaxWeight = 1.f;
+		bBuilt = false;
+		bSparse = false;
+	}
+
+	void FStressMajorization::Pass(FLayoutBuffers& Positions, const float EdgeLength, const int32_t PassIndex,
+	                               const int32_t NumPasses, const float Epsilon)
+	{
+		if (Terms.empty())
+			return;
+
+		// Weights are in hops, Weight * Eta stays the same at any edge length
+		const double EtaMax = 1.0 / MinWeight;
+		const double EtaMin = std::max(static_cast<double>(Epsilon), 1.e-6) / MaxWeight;
+		const double Lambda = NumPasses > 1 ? std::log(EtaMax / EtaMin) / (NumPasses - 1) : 0.0;
+		const float Eta = static_cast<float>(EtaMax * std::exp(-Lambda * std::min(PassIndex, NumPasses - 1)));
+
+		for (size_t i = Terms.size() - 1; i > 0; --i)
+		{
+			std::swap(Terms[i], Terms[Rng() % (i + 1)]);
+		}
+
+		for (const FTerm& Term : Terms)
+		{
+			FVec3 Delta = Positions.Get(Term.I) - Positions.Get(Term.J);
+			float Distance = Delta.Size();
+			if (Distance < GStress_Min_Distance)
+			{
+				const float Angle = static_cast<float>(Rng() & 0xffff) * (6.2831853f / 65536.f);
+				const float Z = static_cast<float>(Rng() & 0xffff) / 32768.f - 1.f;
+				const float Ring = std::sqrt(std::max(1.f - Z * Z, 0.f));
+				Delta = FVec3(std::cos(Angle) * Ring, std::sin(Angle) * Ring, Z) * GStress_Min_Distance;
+				Distance = GStress_Min_Distance;
+			}
+
+			// Move towards the target distance, all the way once Weight * Eta reaches 1
+			const float Mu = std::min(Term.Weight * Eta, 1.f);
+			const FVec3 Correction = Delta * (Mu * (Distance - Term.Distance * EdgeLength) / Distance);
+			if (Term.bMoveBoth)
+			{
+				Positions.Add(Term.I, Correction * -0.5f);
+				Positions.Add(Term.J, Correction * 0.5f);
+			}
+			else
+			{
+				Positions.Add(Term.I, -Correction);
+			}
+		}
+	}
+
+	double FStressMajorization::ComputeStress(const FLayoutBuffers& Positions, const float EdgeLength) const
+	{
+		double Stress = 0.0;
+		for (const FTerm& Term : Terms)
+		{
+			const double Error = (Positions.Get(Term.I) - Positions.Get(Term.J)).Size() - Term.Distance * EdgeLength;
+			Stress += Term.Weight / (EdgeLength * EdgeLength) * Error * Error;
+		}
+		return Stress;
+	}
+
+	size_t FStressMajorization::GetAllocatedSize() const
+	{
+		return Terms.capacity() * sizeof(FTerm);
+	}
+}
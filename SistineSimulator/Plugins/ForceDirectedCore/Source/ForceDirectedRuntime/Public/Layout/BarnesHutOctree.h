@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Layout/LayoutTypes.h"
+
+namespace ForceDirected
+{
+	/**
+	 * A Barnes-Hut octree built over a set of node positions.
+	 * Distant clusters of nodes are treated as a single body located at their center of mass,
+	 * which brings the all-pairs repulsion of the Fruchterman-Reingold layout down to O(N log N).
+	 */
+	class FORCEDIRECTEDRUNTIME_API FBarnesHutOctree
+	{
+	public:
+		// Rebuild the tree from scratch for the given positions.
+		// The positions buffer must outlive any subsequent ComputeRepulsion call.
+		void Build(const FLayoutBuffers& InPositions);
+
+		// Accumulated repulsion acting on the node at NodeIndex, using the K^2 / d force of Fruchterman-Reingold.
+		// @param Theta Opening angle; a cell is approximated when its size / distance is below this value.
+		// @param MaxDistance Bodies and cells farther away than this are ignored entirely.
+		FVec3 ComputeRepulsion(int32_t NodeIndex, float KSquared, float Theta, float MaxDistance) const;
+
+		// Heap memory owned by the tree, in bytes
+		size_t GetAllocatedSize() const;
+
+		void Reset();
+
+	private:
+		struct FCell
+		{
+			FVec3 Center;
+			float HalfExtent = 0.f;
+			FVec3 CenterOfMass;
+			int32_t Mass = 0;
+			// Index of the first of 8 contiguous children, or InvalidIndex for a leaf
+			int32_t FirstChild = InvalidIndex;
+			// Head of the linked list of bodies stored in a leaf, or InvalidIndex
+			int32_t FirstBody = InvalidIndex;
+			int32_t Depth = 0;
+		};
+
+		// Beyond this depth coincident bodies are kept in the same leaf instead of subdividing forever
+		static constexpr int32_t MaxDepth = 20;
+
+		std::vector<FCell> Cells;
+
+		// Next body in the same leaf, indexed by node index
+		std::vector<int32_t> NextBody;
+
+		const FLayoutBuffers* Positions = nullptr;
+
+		int32_t AddCell(const FVec3& Center, float HalfExtent, int32_t Depth);
+		void Insert(int32_t BodyIndex);
+		void Subdivide(int32_t CellIndex);
+		static int32_t GetOctant(const FVec3& Center, const FVec3& Point);
+	};
+}
@@ -0,0 +1,217 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Layout/BarnesHutOctree.h"
+#include "Layout/LayoutGraph.h"
+#include "Layout/LayoutTypes.h"
+#include "Layout/SpatialHashGrid.h"
+#include "Layout/StressMajorization.h"
+
+namespace ForceDirected
+{
+	enum class ERepulsionMethod : uint8_t
+	{
+		// Every pair within RepulsionCutoff, vectorized when bUseSimd is set
+		Exact,
+
+		// Octree approximation with opening angle Theta, falls back to Exact when Theta is 0
+		BarnesHut,
+
+		// Exact repulsion between nodes in neighboring cells of a uniform grid with cell size RepulsionCutoff
+		SpatialHash,
+	};
+
+	enum class ELayoutAlgorithm : uint8_t
+	{
+		// Forces between nodes, cooled until the layout settles
+		FruchtermanReingold,
+
+		// SGD on the stress between layout distances and graph distances, see FStressMajorization
+		StressMajorization,
+	};
+
+	struct FSolverSettings
+	{
+		ELayoutAlgorithm Algorithm = ELayoutAlgorithm::FruchtermanReingold;
+
+		// Distance between nodes the layout stabilizes towards, the length of one hop for stress majorization
+		float KConstant = 15.f;
+
+		ERepulsionMethod RepulsionMethod = ERepulsionMethod::BarnesHut;
+
+		// Barnes-Hut opening angle for repulsion, 0 computes the exact all-pairs repulsion
+		float Theta = 0.5f;
+
+		// Pairs farther apart than this do not repulse each other. Also the cell size of the spatial hash grid.
+		float RepulsionCutoff = 1000.f;
+
+		// Number of tasks the force passes are split into, 1 runs everything on the calling thread
+		int32_t NumTasks = 1;
+
+		// Use the vectorized kernel for exact repulsion instead of the scalar reference. Vectorized with SSE on x64
+		// and NEON on 64-bit ARM, scalar anywhere else.
+		bool bUseSimd = true;
+
+		// Nodes whose net force is shorter than this are left in place
+		float MinMovement = 1.f;
+
+		// Geometric cooling applied after every step until MinTemperature is reached
+		float CoolingFactor = 0.85f;
+		float MinTemperature = 1.5f;
+
+		// The layout counts as converged once no node drifted farther than ConvergenceThreshold
+		// for ConvergenceIterations consecutive steps. 0 iterations disables convergence detection.
+		float ConvergenceThreshold = 0.5f;
+		int32_t ConvergenceIterations = 30;
+
+		// UpdateGraph relaxes the changed nodes and everything within this many hops of them
+		int32_t IncrementalHops = 2;
+
+		// Stress majorization passes, one per Step. The layout is converged after the last one.
+		int32_t StressIterations = 30;
+
+		// Graphs up to this many nodes use exact all-pairs distances, larger ones StressPivots pivots
+		int32_t StressAllPairsNodes = 2000;
+		int32_t StressPivots = 50;
+
+		// Step size of the last pass relative to the smallest, lower ends on a finer layout
+		float StressEpsilon = 0.1f;
+	};
+
+	// Wall time spent in each phase of the last Step, in seconds. Local steps fold repulsion and attraction
+	// into a single pass, which is reported as repulsion.
+	struct FStepTimings
+	{
+		double Repulsion = 0.0;
+		double Attraction = 0.0;
+
+		// Reducing the task accumulators, capping by temperature and moving the nodes
+		double Apply = 0.0;
+	};
+
+	/**
+	 * Fruchterman-Reingold force-directed layout over integer node indices and an undirected edge list.
+	 * Owns no engine state: the host fills GetPositions(), calls Step() and reads back the displacements.
+	 * With Settings.Algorithm set to StressMajorization every Step is a stress majorization pass instead,
+	 * reported through the same displacement, drift and convergence queries.
+	 */
+	class FORCEDIRECTEDRUNTIME_API FFruchtermanReingoldSolver
+	{
+	public:
+		// Replace the graph, compiling the edge list into Graph (see FLayoutGraph::Build).
+		// Positions are zeroed, convergence tracking and the temperature are reset.
+		void SetGraph(int32_t NumNodes, const std::vector<FEdge>& InEdges);
+
+		// Replace the graph but keep the layout. PreviousNodes[v] is the index node v had before, or InvalidIndex
+		// if it is new. Kept nodes keep their positions; new ones start next to their placed neighbors, or at
+		// HostPositions if they have none. Nodes whose neighbors changed and everything within IncrementalHops
+		// of them are then relaxed by Step at a temperature scaled to their count, while every other node
+		// stays frozen, until they converge. Returns the number of nodes being relaxed.
+		int32_t UpdateGraph(int32_t NumNodes, const std::vector<FEdge>& InEdges,
+		                    const std::vector<int32_t>& PreviousNodes, const FLayoutBuffers& HostPositions);
+
+		// Whether Step only relaxes the neighborhood of the last UpdateGraph
+		bool IsRelaxingLocally() const { return !ActiveNodes.empty(); }
+		int32_t GetNumActiveNodes() const { return static_cast<int32_t>(ActiveNodes.size()); }
+
+		// Unfreeze everything, following steps move all nodes again
+		void EndLocalRelayout();
+
+		// Changing the stress majorization node or pivot limits recomputes the graph distances on the next Step
+		void SetSettings(const FSolverSettings& InSettings);
+		const FSolverSettings& GetSettings() const { return Settings; }
+
+		// How the force passes are dispatched when Settings.NumTasks > 1
+		void SetParallelFor(FParallelForFunction InParallelFor) { ParallelFor = std::move(InParallelFor); }
+
+		// Restart cooling from 10 * sqrt(NumNodes)
+		void ResetTemperature();
+
+		// Continue cooling from the given temperature, e.g. a low one for a warm start from a known layout.
+		// Stress majorization skips its coarse first half of passes instead.
+		void SetTemperature(float InTemperature);
+		float GetTemperature() const { return Temperature; }
+
+		int32_t GetNumNodes() const { return Graph.GetNumNodes(); }
+		const FLayoutGraph& GetGraph() const { return Graph; }
+
+		FLayoutBuffers& GetPositions() { return Positions; }
+		const FLayoutBuffers& GetPositions() const { return Positions; }
+
+		// How far each node moved during the last Step, after temperature capping
+		const FLayoutBuffers& GetDisplacements() const { return Displacements; }
+
+		// Largest displacement of the last Step
+		float GetMaxDisplacement() const { return MaxDisplacement; }
+
+		// Drift is a node's displacement averaged over the last two steps. Once the temperature reaches its
+		// minimum, settled nodes jitter back and forth by a full step every iteration; drift cancels that out
+		// and only measures actual progress. Energy is the sum of squared drifts.
+		float GetMaxDrift() const { return MaxDrift; }
+		float GetEnergy() const { return Energy; }
+
+		const FStepTimings& GetLastStepTimings() const { return LastStepTimings; }
+
+		// Heap memory owned by the solver (graph, per-node buffers, acceleration structures), in bytes
+		size_t GetAllocatedSize() const;
+
+		// Whether the last ConvergenceIterations steps all stayed below ConvergenceThreshold, or for stress
+		// majorization whether all StressIterations passes ran
+		bool IsConverged() const;
+
+		// Start counting quiet steps from zero again, e.g. after the host moved a node. Stress majorization
+		// resumes from halfway through its passes.
+		void ResetConvergence();
+
+		const FStressMajorization& GetStressMajorization() const { return Stress; }
+
+		// A single iteration: accumulate forces, cap them by temperature, move Positions and cool down
+		void Step();
+
+	private:
+		FSolverSettings Settings;
+		FParallelForFunction ParallelFor;
+
+		FLayoutGraph Graph;
+
+		float Temperature = 0.f; // maximum allowable movement, used for cooling mechanism
+		FLayoutBuffers Positions;
+		FLayoutBuffers Movements;
+		FLayoutBuffers Displacements;
+
+		float MaxDisplacement = 0.f;
+		float MaxDrift = 0.f;
+		float Energy = 0.f;
+		int32_t NumQuietIterations = 0;
+		FStepTimings LastStepTimings;
+
+		// Rebuilt from Positions every step for the matching repulsion method
+		FBarnesHutOctree Octree;
+		FSpatialHashGrid Grid;
+
+		// Private force accumulator per task, reduced into Movements at the end of each step
+		std::vector<FLayoutBuffers> TaskForces;
+
+		// Nodes relaxed by local steps after UpdateGraph, empty otherwise
+		std::vector<int32_t> ActiveNodes;
+
+		// Every other node, which is frozen during local steps and only repulses
+		FSpatialHashGrid FrozenGrid;
+
+		// A local step, work proportional to the active nodes and whatever lies within the cutoff of them
+		void StepLocal();
+
+		// Terms compiled on the first stress step after the graph or its settings changed
+		FStressMajorization Stress;
+		int32_t StressPass = 0;
+
+		// A stress majorization pass, moving every node
+		void StepStress();
+
+		// Per task maxima of squared displacement and drift, and sum of squared drifts, reduced after the step
+		std::vector<float> TaskMaxDisplacementSquared;
+		std::vector<float> TaskMaxDriftSquared;
+		std::vector<double> TaskEnergy;
+	};
+}
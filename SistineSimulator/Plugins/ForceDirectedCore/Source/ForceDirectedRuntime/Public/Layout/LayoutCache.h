@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Layout/LayoutGraph.h"
+#include "Layout/LayoutTypes.h"
+
+#include <list>
+#include <string_view>
+#include <unordered_map>
+
+namespace ForceDirected
+{
+	/** Incremental 64-bit FNV-1a hash, stable across runs and platforms of the same endianness. */
+	class FORCEDIRECTEDRUNTIME_API FLayoutHasher
+	{
+	public:
+		explicit FLayoutHasher(uint64_t Seed = OffsetBasis) : Hash(Seed)
+		{
+		}
+
+		void AddBytes(const void* Data, size_t Size);
+		void AddInt(int64_t Value) { AddBytes(&Value, sizeof(Value)); }
+		void AddFloat(float Value) { AddBytes(&Value, sizeof(Value)); }
+
+		// Length prefixed, so consecutive strings can't run into each other
+		void AddString(std::string_view Value);
+
+		uint64_t Get() const { return Hash; }
+
+		static constexpr uint64_t OffsetBasis = 14695981039346656037ull;
+
+	private:
+		uint64_t Hash;
+	};
+
+	// Hash of the graph's topology with node v renumbered to CanonicalIndex[v], so the same graph hashes the
+	// same whatever order its nodes and edges were added in, as long as the host numbers nodes consistently.
+	// An empty CanonicalIndex keeps the graph's own numbering.
+	FORCEDIRECTEDRUNTIME_API uint64_t HashGraphTopology(const FLayoutGraph& Graph,
+	                                                    const std::vector<int32_t>& CanonicalIndex,
+	                                                    uint64_t Seed = FLayoutHasher::OffsetBasis);
+
+	/**
+	 * Settled layouts by a key the host derives from everything the layout depends on, e.g. with
+	 * HashGraphTopology. Serializes to a compact binary blob in native byte order for a local cache file.
+	 *
+	 * Holds at most MaxBytes of positions. Storing past that evicts the least recently found or stored entries.
+	 */
+	class FORCEDIRECTEDRUNTIME_API FLayoutCache
+	{
+	public:
+		static constexpr size_t DefaultMaxBytes = 64ull << 20;
+
+		explicit FLayoutCache(size_t InMaxBytes = DefaultMaxBytes) : MaxBytes(InMaxBytes)
+		{
+		}
+
+		// Copy the positions stored under Key into OutPositions and mark the entry as recently used. Fails if
+		// there are none, or if they were stored for a different number of nodes.
+		bool Find(uint64_t Key, int32_t NumNodes, FLayoutBuffers& OutPositions);
+
+		// Replaces whatever was stored under Key. Positions larger than MaxBytes on their own are not kept.
+		void Store(uint64_t Key, const FLayoutBuffers& Positions);
+		bool Remove(uint64_t Key);
+
+		int32_t Num() const { return static_cast<int32_t>(Entries.size()); }
+		void Reset();
+
+		// Evicts right away if the entries no longer fit
+		void SetMaxBytes(size_t InMaxBytes);
+		size_t GetMaxBytes() const { return MaxBytes; }
+
+		// Bytes of positions held by all entries
+		size_t GetNumBytes() const { return NumBytes; }
+
+		// Magic, version and entry count, then every entry's key, node count and X, Y, Z arrays, least recently
+		// used first so Load restores the order
+		void Save(std::vector<uint8_t>& OutBytes) const;
+
+		// Replace the contents with a blob written by Save, evicting what doesn't fit in MaxBytes. A blob from
+		// another version or a truncated one leaves the cache empty and returns false.
+		bool Load(const std::vector<uint8_t>& Bytes);
+
+	private:
+		struct FEntry
+		{
+			FLayoutBuffers Positions;
+
+			// Position in Recency
+			std::list<uint64_t>::iterator Use;
+		};
+
+		std::unordered_map<uint64_t, FEntry> Entries;
+
+		// Keys from most to least recently used
+		std::list<uint64_t> Recency;
+
+		size_t MaxBytes;
+		size_t NumBytes = 0;
+
+		void EvictToFit();
+	};
+}
@@ -0,0 +1,43 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Layout/LayoutTypes.h"
+
+namespace ForceDirected
+{
+	/**
+	 * Undirected graph over node indices [0, NumNodes), compiled once into compressed sparse row form:
+	 * the neighbors of node v are Neighbors[Offsets[v] .. Offsets[v + 1]), sorted ascending.
+	 * Also keeps the deduplicated edge list (A < B) for passes that want every edge exactly once.
+	 */
+	class FORCEDIRECTEDRUNTIME_API FLayoutGraph
+	{
+	public:
+		// Compile from an arbitrary edge list. Duplicates and either direction collapse into one edge,
+		// self loops and indices outside [0, NumNodes) are dropped.
+		void Build(int32_t InNumNodes, const std::vector<FEdge>& InEdges);
+
+		void Reset();
+
+		int32_t GetNumNodes() const { return NumNodes; }
+		int32_t GetNumEdges() const { return static_cast<int32_t>(Edges.size()); }
+
+		int32_t GetDegree(const int32_t Node) const { return Offsets[Node + 1] - Offsets[Node]; }
+		const int32_t* NeighborsBegin(const int32_t Node) const { return Neighbors.data() + Offsets[Node]; }
+		const int32_t* NeighborsEnd(const int32_t Node) const { return Neighbors.data() + Offsets[Node + 1]; }
+
+		const std::vector<int32_t>& GetOffsets() const { return Offsets; }
+		const std::vector<int32_t>& GetNeighbors() const { return Neighbors; }
+		const std::vector<FEdge>& GetEdges() const { return Edges; }
+
+		// Heap memory owned by the graph, in bytes
+		size_t GetAllocatedSize() const;
+
+	private:
+		int32_t NumNodes = 0;
+		std::vector<int32_t> Offsets;
+		std::vector<int32_t> Neighbors;
+		std::vector<FEdge> Edges;
+	};
+}
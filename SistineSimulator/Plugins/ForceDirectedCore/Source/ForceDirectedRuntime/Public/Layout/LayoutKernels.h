@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Layout/LayoutTypes.h"
+
+namespace ForceDirected
+{
+	/**
+	 * Fruchterman-Reingold force kernels working on FLayoutBuffers.
+	 */
+	struct FORCEDIRECTEDRUNTIME_API FLayoutKernels
+	{
+		// Exact repulsion acting on nodes [Begin, End) from every other node, added to OutForces.
+		// Each node only writes its own entry, so disjoint ranges can run concurrently.
+		// Scalar reference implementation.
+		static void RepulsionScalar(const FLayoutBuffers& Positions, int32_t Begin, int32_t End, float KSquared,
+		                            float MaxDistance, FLayoutBuffers& OutForces);
+
+		// Same as RepulsionScalar, but processes 4 other nodes per instruction with SSE on x64 or NEON on 64-bit
+		// ARM. Other targets fall back to the scalar kernel.
+		static void RepulsionSimd(const FLayoutBuffers& Positions, int32_t Begin, int32_t End, float KSquared,
+		                          float MaxDistance, FLayoutBuffers& OutForces);
+
+		// Attraction along Edges[Begin, End), added to both endpoints in OutForces.
+		static void Attraction(const FLayoutBuffers& Positions, const FEdge* Edges, int32_t Begin, int32_t End,
+		                       float KConstant, FLayoutBuffers& OutForces);
+
+		// Runs both repulsion kernels over all of Positions and returns the largest per-node difference,
+		// relative to the magnitude of the scalar result.
+		static float CompareRepulsionKernels(const FLayoutBuffers& Positions, float KSquared, float MaxDistance);
+
+		// Whether RepulsionSimd is actually vectorized on this build
+		static bool IsSimdAvailable();
+	};
+}
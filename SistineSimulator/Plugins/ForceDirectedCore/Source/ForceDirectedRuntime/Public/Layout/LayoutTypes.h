@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// The layout core is plain C++ with no engine dependency, so it can also be built by the
+// headless Standalone target. Keep engine headers out of everything under Layout/.
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#ifndef FORCEDIRECTEDRUNTIME_API
+#define FORCEDIRECTEDRUNTIME_API
+#endif
+
+namespace ForceDirected
+{
+	constexpr int32_t InvalidIndex = -1;
+
+	/** Minimal float 3-vector for the layout core. */
+	struct FVec3
+	{
+		float X = 0.f;
+		float Y = 0.f;
+		float Z = 0.f;
+
+		FVec3() = default;
+
+		FVec3(const float InX, const float InY, const float InZ) : X(InX), Y(InY), Z(InZ)
+		{
+		}
+
+		FVec3 operator+(const FVec3& Other) const { return FVec3(X + Other.X, Y + Other.Y, Z + Other.Z); }
+		FVec3 operator-(const FVec3& Other) const { return FVec3(X - Other.X, Y - Other.Y, Z - Other.Z); }
+		FVec3 operator-() const { return FVec3(-X, -Y, -Z); }
+		FVec3 operator*(const float Scale) const { return FVec3(X * Scale, Y * Scale, Z * Scale); }
+		FVec3 operator/(const float Scale) const { return FVec3(X / Scale, Y / Scale, Z / Scale); }
+
+		FVec3& operator+=(const FVec3& Other)
+		{
+			X += Other.X;
+			Y += Other.Y;
+			Z += Other.Z;
+			return *this;
+		}
+
+		FVec3& operator-=(const FVec3& Other)
+		{
+			X -= Other.X;
+			Y -= Other.Y;
+			Z -= Other.Z;
+			return *this;
+		}
+
+		float SizeSquared() const { return X * X + Y * Y + Z * Z; }
+		float Size() const { return std::sqrt(SizeSquared()); }
+		bool IsZero() const { return X == 0.f && Y == 0.f && Z == 0.f; }
+	};
+
+	/**
+	 * Structure-of-arrays float buffers for per-node layout state (positions, forces).
+	 * Keeping each component contiguous lets the force kernels load several nodes per SIMD instruction.
+	 */
+	struct FLayoutBuffers
+	{
+		std::vector<float> X;
+		std::vector<float> Y;
+		std::vector<float> Z;
+
+		int32_t Num() const { return static_cast<int32_t>(X.size()); }
+
+		size_t GetAllocatedSize() const { return (X.capacity() + Y.capacity() + Z.capacity()) * sizeof(float); }
+
+		void SetNumZeroed(const int32_t NewNum)
+		{
+			X.assign(NewNum, 0.f);
+			Y.assign(NewNum, 0.f);
+			Z.assign(NewNum, 0.f);
+		}
+
+		void Reset()
+		{
+			X.clear();
+			Y.clear();
+			Z.clear();
+		}
+
+		FVec3 Get(const int32_t Index) const { return FVec3(X[Index], Y[Index], Z[Index]); }
+
+		void Set(const int32_t Index, const FVec3& Value)
+		{
+			X[Index] = Value.X;
+			Y[Index] = Value.Y;
+			Z[Index] = Value.Z;
+		}
+
+		void Add(const int32_t Index, const FVec3& Value)
+		{
+			X[Index] += Value.X;
+			Y[Index] += Value.Y;
+			Z[Index] += Value.Z;
+		}
+	};
+
+	/** An undirected edge between two node indices. */
+	struct FEdge
+	{
+		int32_t A = InvalidIndex;
+		int32_t B = InvalidIndex;
+	};
+
+	/**
+	 * Runs Body(Task) for every Task in [0, NumTasks), possibly concurrently, and returns once all are done.
+	 * The engine adapter plugs ParallelFor in here; the core never creates threads on its own unless asked to.
+	 */
+	using FParallelForFunction = std::function<void(int32_t NumTasks, const std::function<void(int32_t)>& Body)>;
+
+	// Dispatches through ParallelFor, or runs inline when it is unset or there is a single task
+	FORCEDIRECTEDRUNTIME_API void RunTasks(const FParallelForFunction& ParallelFor, int32_t NumTasks,
+	                                       const std::function<void(int32_t)>& Body);
+
+	// A ParallelFor backed by std::thread, for hosts without a task system (e.g. the Standalone target)
+	FORCEDIRECTEDRUNTIME_API FParallelForFunction MakeThreadParallelFor();
+}
@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Layout/LayoutTypes.h"
+
+namespace ForceDirected
+{
+	/**
+	 * A uniform grid of cubic cells hashed by their integer coordinates, built over a set of node positions.
+	 * With the cell size equal to the repulsion cutoff every pair within range lies in the same or a neighboring
+	 * cell, so repulsion only visits 27 cells per node. For layouts spread out relative to the cutoff this makes
+	 * the pass roughly O(N); when everything collapses into a few cells it degrades to the all-pairs cost.
+	 */
+	class FORCEDIRECTEDRUNTIME_API FSpatialHashGrid
+	{
+	public:
+		// Rebuild the grid for the given positions with cells of CellSize, which is also the cutoff radius.
+		void Build(const FLayoutBuffers& InPositions, float InCellSize);
+
+		// Exact K^2 / d repulsion acting on the node at NodeIndex from every node closer than the cell size
+		FVec3 ComputeRepulsion(int32_t NodeIndex, float KSquared) const;
+
+		// Same for an arbitrary point, e.g. a node that is not part of the grid
+		FVec3 ComputeRepulsionAt(const FVec3& Position, float KSquared) const;
+
+		float GetCellSize() const { return CellSize; }
+		int32_t GetNumOccupiedCells() const { return NumOccupiedCells; }
+		size_t GetAllocatedSize() const;
+
+		void Reset();
+
+	private:
+		struct FSlot
+		{
+			int64_t Key = EmptyKey;
+			// Range of this cell in SortedNodes / SortedPositions
+			int32_t Begin = 0;
+			int32_t End = 0;
+		};
+
+		static constexpr int64_t EmptyKey = -1;
+
+		// Cell coordinates are clamped to 21 bits each so a cell packs into one 64-bit key
+		static constexpr int32_t CoordinateBits = 21;
+		static constexpr int32_t CoordinateBias = 1 << (CoordinateBits - 1);
+
+		float CellSize = 0.f;
+		int32_t NumOccupiedCells = 0;
+
+		// Open addressing hash table from cell key to node range, sized to a power of two
+		std::vector<FSlot> Slots;
+
+		// Node indices and their positions grouped by cell, so a cell is one contiguous scan
+		std::vector<int32_t> SortedNodes;
+		FLayoutBuffers SortedPositions;
+
+		// Where every node ended up in SortedNodes, indexed by node index
+		std::vector<int32_t> SortedIndices;
+
+		int32_t ToCell(float Coordinate) const;
+		static int64_t MakeKey(int32_t CellX, int32_t CellY, int32_t CellZ);
+		int32_t FindSlot(int64_t Key) const;
+		int32_t FindOrAddSlot(int64_t Key);
+	};
+}
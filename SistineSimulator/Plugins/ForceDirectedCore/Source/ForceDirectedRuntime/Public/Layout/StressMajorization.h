@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Layout/LayoutGraph.h"
+#include "Layout/LayoutTypes.h"
+
+#include <random>
+
+namespace ForceDirected
+{
+	/**
+	 * Stress majorization by stochastic gradient descent (Zheng, Pawar and Goodman, "Graph Drawing by Stochastic
+	 * Gradient Descent", the s_gd2 family). Positions are moved so Euclidean distances match graph distances
+	 * times an edge length, one pair of nodes (a term) at a time, with a step size annealed over a fixed number
+	 * of passes. That typically settles in about 30 passes and avoids most local minima of force-directed layouts.
+	 *
+	 * Small graphs use every pair of nodes. Larger ones use the sparse approximation: exact terms along the edges
+	 * plus terms between every node and a set of max-min pivots, weighted by how many nodes each pivot stands in for.
+	 * Pairs in different connected components are kept one hop farther apart than the largest graph distance.
+	 */
+	class FORCEDIRECTEDRUNTIME_API FStressMajorization
+	{
+	public:
+		// Compute the graph distances and compile the terms. All-pairs distances come from one BFS per node,
+		// split over NumTasks through ParallelFor. Graphs with more than MaxAllPairsNodes nodes use NumPivots pivots.
+		void Build(const FLayoutGraph& Graph, int32_t MaxAllPairsNodes, int32_t NumPivots,
+		           const FParallelForFunction& ParallelFor, int32_t NumTasks);
+
+		void Reset();
+
+		bool IsBuilt() const { return bBuilt; }
+		bool IsSparse() const { return bSparse; }
+		int32_t GetNumTerms() const { return static_cast<int32_t>(Terms.size()); }
+
+		// One SGD pass over every term in random order. The step size anneals exponentially from 1 / MinWeight at
+		// pass 0 to Epsilon / MaxWeight at pass NumPasses - 1. Graph distances are scaled by EdgeLength.
+		void Pass(FLayoutBuffers& Positions, float EdgeLength, int32_t PassIndex, int32_t NumPasses, float Epsilon);
+
+		// Weighted stress of the layout over the compiled terms, sum of w * (|Pi - Pj| - d)^2
+		double ComputeStress(const FLayoutBuffers& Positions, float EdgeLength) const;
+
+		// Heap memory owned by the terms, in bytes
+		size_t GetAllocatedSize() const;
+
+	private:
+		struct FTerm
+		{
+			int32_t I = InvalidIndex;
+			int32_t J = InvalidIndex;
+
+			// Graph distance in hops
+			float Distance = 0.f;
+
+			// s / Distance^2, with s = 1 for exact terms
+			float Weight = 0.f;
+
+			// Pivot terms only move I, the pivot is moved by its own terms
+			bool bMoveBoth = true;
+		};
+
+		std::vector<FTerm> Terms;
+		float MinWeight = 1.f;
+		float MaxWeight = 1.f;
+		bool bBuilt = false;
+		bool bSparse = false;
+
+		// Shuffles the terms every pass, seeded in Build so a layout is reproducible
+		std::mt19937 Rng;
+
+		void BuildAllPairs(const FLayoutGraph& Graph, const FParallelForFunction& ParallelFor, int32_t NumTasks);
+		void BuildSparse(const FLayoutGraph& Graph, int32_t NumPivots, const FParallelForFunction& ParallelFor,
+		                 int32_t NumTasks);
+	};
+}
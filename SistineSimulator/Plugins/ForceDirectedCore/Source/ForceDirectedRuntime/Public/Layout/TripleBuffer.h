@@ -0,0 +1,69 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Layout/LayoutTypes.h"
+
+#include <atomic>
+
+namespace ForceDirected
+{
+	/**
+	 * Lock-free single-producer / single-consumer triple buffer.
+	 * The writer always has a private buffer to fill and never waits; the reader always sees the most recently
+	 * published buffer in full, skipping any it was too slow to pick up.
+	 */
+	template <typename T>
+	class TTripleBuffer
+	{
+	public:
+		// Writer side: fill the buffer returned here, then Publish() it
+		T& GetWriteBuffer() { return Buffers[WriteIndex]; }
+
+		// Writer side: hand the write buffer to the reader and take over the stale one
+		void Publish()
+		{
+			WriteIndex = Shared.exchange(WriteIndex | DirtyBit, std::memory_order_acq_rel) & IndexMask;
+		}
+
+		// Reader side: swaps in the newest published buffer, returns false if nothing new was published
+		bool Update()
+		{
+			if ((Shared.load(std::memory_order_acquire) & DirtyBit) == 0)
+				return false;
+			ReadIndex = Shared.exchange(ReadIndex, std::memory_order_acq_rel) & IndexMask;
+			return true;
+		}
+
+		// Reader side: the buffer obtained by the last successful Update()
+		const T& GetReadBuffer() const { return Buffers[ReadIndex]; }
+
+		// Forget anything published. Neither side may be in use concurrently.
+		void Reset()
+		{
+			WriteIndex = 0;
+			Shared.store(1, std::memory_order_relaxed);
+			ReadIndex = 2;
+		}
+
+	private:
+		static constexpr int32_t IndexMask = 3;
+		static constexpr int32_t DirtyBit = 4;
+
+		T Buffers[3];
+		int32_t WriteIndex = 0;
+		std::atomic<int32_t> Shared{1};
+		int32_t ReadIndex = 2;
+	};
+
+	/** Positions published by a layout running on another thread. */
+	struct FLayoutSnapshot
+	{
+		FLayoutBuffers Positions;
+
+		// Number of steps the solver had completed when this was taken
+		int64_t Iteration = 0;
+
+		float Temperature = 0.f;
+	};
+}
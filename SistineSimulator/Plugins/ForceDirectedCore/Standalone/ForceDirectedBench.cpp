@@ -0,0 +1,538 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Headless benchmark for the layout core: times Fruchterman-Reingold steps on a random graph,
+// sweeps node density to compare the repulsion methods, or runs the scaling suite over synthetic graph
+// families and writes the results as CSV/JSON for tracking regressions between builds.
+
+#include "StandaloneCommon.h"
+#include "Layout/BarnesHutOctree.h"
+#include "Layout/FruchtermanReingoldSolver.h"
+#include "Layout/LayoutKernels.h"
+#include "Layout/SpatialHashGrid.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace ForceDirected;
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: ForceDirectedBench [options]\n"
+			"  --nodes N        Number of nodes (default 10000)\n"
+			"  --degree D       Average edges per node (default 3)\n"
+			"  --iterations I   Steps to time (default 20)\n"
+			"  --method M       Repulsion method: exact, barneshut or grid (default barneshut)\n"
+			"  --theta T        Barnes-Hut opening angle, 0 for exact (default 0.5)\n"
+			"  --cutoff C       Repulsion cutoff and grid cell size (default 1000)\n"
+			"  --extent E       Half extent of the initial positions (default 20 * sqrt(nodes))\n"
+			"  --tasks T        Parallel tasks, 0 for hardware concurrency (default 0)\n"
+			"  --scalar         Use the scalar repulsion kernel\n"
+			"  --stress         Lay out by stress majorization instead of forces, --method and --theta\n"
+			"                   are ignored\n"
+			"  --pivots P       Stress majorization pivots above 2000 nodes, 0 for all pairs (default 50)\n"
+			"  --sweep          Time one single-threaded repulsion pass of every method over a range of\n"
+			"                   node counts and densities (nodes per cutoff-sized cube) instead\n"
+			"  --suite          Solve every generated graph family at every size until it converges instead\n"
+			"  --generators G   Comma separated families for --suite: grid, erdosrenyi, scalefree, tree,\n"
+			"                   clusters (default all)\n"
+			"  --sizes S        Comma separated node counts for --suite (default 100,1000,10000,100000)\n"
+			"  --max-iterations I  Give up on a --suite run after this many steps (default 500)\n"
+			"  --csv PATH       Write the --suite results as CSV\n"
+			"  --json PATH      Write the --suite results as JSON\n");
+	}
+
+	std::vector<std::string> SplitList(const char* List)
+	{
+		std::vector<std::string> Items;
+		std::string Item;
+		for (const char* c = List; ; ++c)
+		{
+			if (*c == ',' || *c == '\0')
+			{
+				if (!Item.empty())
+				{
+					Items.push_back(Item);
+				}
+				Item.clear();
+				if (*c == '\0')
+					break;
+			}
+			else
+			{
+				Item += *c;
+			}
+		}
+		return Items;
+	}
+
+	struct FGraphFamily
+	{
+		const char* Name;
+		std::vector<FEdge> (*Generate)(int32_t NumNodes, uint32_t Seed);
+	};
+
+	std::vector<FEdge> GenerateGrid(const int32_t NumNodes, uint32_t)
+	{
+		return Standalone::GridEdges(NumNodes);
+	}
+
+	std::vector<FEdge> GenerateErdosRenyi(const int32_t NumNodes, const uint32_t Seed)
+	{
+		return Standalone::ErdosRenyiEdges(NumNodes, 3.f, Seed);
+	}
+
+	std::vector<FEdge> GenerateScaleFree(const int32_t NumNodes, const uint32_t Seed)
+	{
+		return Standalone::ScaleFreeEdges(NumNodes, 2, Seed);
+	}
+
+	std::vector<FEdge> GenerateTree(const int32_t NumNodes, uint32_t)
+	{
+		return Standalone::TreeEdges(NumNodes, 3);
+	}
+
+	std::vector<FEdge> GenerateClusters(const int32_t NumNodes, const uint32_t Seed)
+	{
+		return Standalone::ClusterEdges(NumNodes, 8, 3, Seed);
+	}
+
+	const FGraphFamily GraphFamilies[] = {
+		{"grid", GenerateGrid},
+		{"erdosrenyi", GenerateErdosRenyi},
+		{"scalefree", GenerateScaleFree},
+		{"tree", GenerateTree},
+		{"clusters", GenerateClusters},
+	};
+
+	struct FSuiteResult
+	{
+		std::string Family;
+		int32_t NumNodes = 0;
+		int32_t NumEdges = 0;
+		int32_t NumIterations = 0;
+		bool bConverged = false;
+		double MsPerIteration = 0.0;
+		double RepulsionMs = 0.0;
+		double AttractionMs = 0.0;
+		double ApplyMs = 0.0;
+		size_t PeakSolverBytes = 0;
+		long PeakProcessKb = 0;
+		double EdgeLengthCv = 0.0;
+		double Stress = 0.0;
+	};
+
+	// High water mark of the whole process, it never goes down between runs
+	long GetPeakResidentKb()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		rusage Usage{};
+		if (getrusage(RUSAGE_SELF, &Usage) == 0)
+		{
+#if defined(__APPLE__)
+			return Usage.ru_maxrss / 1024;
+#else
+			return Usage.ru_maxrss;
+#endif
+		}
+#endif
+		return 0;
+	}
+
+	// Coefficient of variation of the edge lengths, 0 when every edge has the same length
+	double EdgeLengthCv(const FLayoutGraph& Graph, const FLayoutBuffers& Positions)
+	{
+		double Sum = 0.0, SumSquared = 0.0;
+		for (const FEdge& Edge : Graph.GetEdges())
+		{
+			const double Length = (Positions.Get(Edge.A) - Positions.Get(Edge.B)).Size();
+			Sum += Length;
+			SumSquared += Length * Length;
+		}
+		const double NumEdges = static_cast<double>(Graph.GetNumEdges());
+		if (NumEdges == 0.0 || Sum == 0.0)
+			return 0.0;
+
+		const double Mean = Sum / NumEdges;
+		return std::sqrt(std::max(SumSquared / NumEdges - Mean * Mean, 0.0)) / Mean;
+	}
+
+	// Normalized stress of the layout against graph distances, sampled from a few BFS sources: the mean of
+	// ((s * d - D) / D)^2 over connected pairs, with the layout scale s that minimizes it. 0 is a perfect embedding.
+	double SampledStress(const FLayoutGraph& Graph, const FLayoutBuffers& Positions, const int32_t NumSources)
+	{
+		const int32_t NumNodes = Graph.GetNumNodes();
+		if (NumNodes < 2)
+			return 0.0;
+
+		std::vector<int32_t> Distances(NumNodes), Queue(NumNodes);
+		std::vector<double> Ratios;
+		const int32_t Sources = std::min(NumSources, NumNodes);
+		for (int32_t i = 0; i < Sources; ++i)
+		{
+			const int32_t Source = static_cast<int32_t>(static_cast<int64_t>(NumNodes) * i / Sources);
+			std::fill(Distances.begin(), Distances.end(), -1);
+			Distances[Source] = 0;
+			Queue[0] = Source;
+			for (int32_t Head = 0, Tail = 1; Head < Tail; ++Head)
+			{
+				const int32_t v = Queue[Head];
+				for (const int32_t* u = Graph.NeighborsBegin(v); u != Graph.NeighborsEnd(v); ++u)
+				{
+					if (Distances[*u] < 0)
+					{
+						Distances[*u] = Distances[v] + 1;
+						Queue[Tail++] = *u;
+					}
+				}
+			}
+
+			// d / D per reachable pair
+			for (int32_t v = 0; v < NumNodes; ++v)
+			{
+				if (Distances[v] > 0)
+				{
+					Ratios.push_back((Positions.Get(v) - Positions.Get(Source)).Size() / Distances[v]);
+				}
+			}
+		}
+		if (Ratios.empty())
+			return 0.0;
+
+		// Minimizing sum (s * r - 1)^2 gives s = sum r / sum r^2
+		double SumRatio = 0.0, SumRatioSquared = 0.0;
+		for (const double Ratio : Ratios)
+		{
+			SumRatio += Ratio;
+			SumRatioSquared += Ratio * Ratio;
+		}
+		const double Scale = SumRatioSquared > 0.0 ? SumRatio / SumRatioSquared : 0.0;
+		double Stress = 0.0;
+		for (const double Ratio : Ratios)
+		{
+			Stress += (Scale * Ratio - 1.0) * (Scale * Ratio - 1.0);
+		}
+		return Stress / static_cast<double>(Ratios.size());
+	}
+
+	FSuiteResult RunSuiteCase(const FGraphFamily& Family, const int32_t NumNodes, const FSolverSettings& Settings,
+	                          const int32_t MaxIterations)
+	{
+		FSuiteResult Result;
+		Result.Family = Family.Name;
+		Result.NumNodes = NumNodes;
+
+		FFruchtermanReingoldSolver Solver;
+		Solver.SetSettings(Settings);
+		Solver.SetParallelFor(MakeThreadParallelFor());
+		Solver.SetGraph(NumNodes, Family.Generate(NumNodes, 1));
+		Standalone::RandomizePositions(Solver.GetPositions(), NumNodes,
+		                               20.f * std::sqrt(static_cast<float>(NumNodes)), 2);
+		Result.NumEdges = Solver.GetGraph().GetNumEdges();
+
+		double TotalMs = 0.0;
+		while (Result.NumIterations < MaxIterations && !Solver.IsConverged())
+		{
+			const auto Start = std::chrono::steady_clock::now();
+			Solver.Step();
+			TotalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+			const FStepTimings& Timings = Solver.GetLastStepTimings();
+			Result.RepulsionMs += Timings.Repulsion * 1000.0;
+			Result.AttractionMs += Timings.Attraction * 1000.0;
+			Result.ApplyMs += Timings.Apply * 1000.0;
+			Result.PeakSolverBytes = std::max(Result.PeakSolverBytes, Solver.GetAllocatedSize());
+			++Result.NumIterations;
+		}
+
+		const double NumIterations = std::max(Result.NumIterations, 1);
+		Result.bConverged = Solver.IsConverged();
+		Result.MsPerIteration = TotalMs / NumIterations;
+		Result.RepulsionMs /= NumIterations;
+		Result.AttractionMs /= NumIterations;
+		Result.ApplyMs /= NumIterations;
+		Result.PeakProcessKb = GetPeakResidentKb();
+		Result.EdgeLengthCv = EdgeLengthCv(Solver.GetGraph(), Solver.GetPositions());
+		Result.Stress = SampledStress(Solver.GetGraph(), Solver.GetPositions(), 16);
+		return Result;
+	}
+
+	bool WriteCsv(const char* Path, const std::vector<FSuiteResult>& Results)
+	{
+		FILE* File = std::fopen(Path, "w");
+		if (!File)
+			return false;
+
+		std::fprintf(File, "family,nodes,edges,iterations,converged,ms_per_iteration,repulsion_ms,attraction_ms,"
+		             "apply_ms,peak_solver_bytes,peak_process_kb,edge_length_cv,stress\n");
+		for (const FSuiteResult& Result : Results)
+		{
+			std::fprintf(File, "%s,%d,%d,%d,%d,%.4f,%.4f,%.4f,%.4f,%zu,%ld,%.5f,%.5f\n", Result.Family.c_str(),
+			             Result.NumNodes, Result.NumEdges, Result.NumIterations, Result.bConverged ? 1 : 0,
+			             Result.MsPerIteration, Result.RepulsionMs, Result.AttractionMs, Result.ApplyMs,
+			             Result.PeakSolverBytes, Result.PeakProcessKb, Result.EdgeLengthCv, Result.Stress);
+		}
+		return std::fclose(File) == 0;
+	}
+
+	bool WriteJson(const char* Path, const std::vector<FSuiteResult>& Results, const FSolverSettings& Settings,
+	               const int32_t MaxIterations)
+	{
+		FILE* File = std::fopen(Path, "w");
+		if (!File)
+			return false;
+
+		std::fprintf(File, "{\n  \"settings\": {\"algorithm\": %d, \"method\": %d, \"theta\": %g, \"cutoff\": %g, "
+		             "\"tasks\": %d, \"simd\": %s, \"max_iterations\": %d},\n  \"runs\": [",
+		             static_cast<int32_t>(Settings.Algorithm), static_cast<int32_t>(Settings.RepulsionMethod),
+		             Settings.Theta, Settings.RepulsionCutoff, Settings.NumTasks, Settings.bUseSimd ? "true" : "false",
+		             MaxIterations);
+		for (size_t i = 0; i < Results.size(); ++i)
+		{
+			const FSuiteResult& Result = Results[i];
+			std::fprintf(File, "%s\n    {\"family\": \"%s\", \"nodes\": %d, \"edges\": %d, \"iterations\": %d, "
+			             "\"converged\": %s, \"ms_per_iteration\": %.4f, \"repulsion_ms\": %.4f, "
+			             "\"attraction_ms\": %.4f, \"apply_ms\": %.4f, \"peak_solver_bytes\": %zu, "
+			             "\"peak_process_kb\": %ld, \"edge_length_cv\": %.5f, \"stress\": %.5f}",
+			             i == 0 ? "" : ",", Result.Family.c_str(), Result.NumNodes, Result.NumEdges,
+			             Result.NumIterations, Result.bConverged ? "true" : "false", Result.MsPerIteration,
+			             Result.RepulsionMs, Result.AttractionMs, Result.ApplyMs, Result.PeakSolverBytes,
+			             Result.PeakProcessKb, Result.EdgeLengthCv, Result.Stress);
+		}
+		std::fprintf(File, "\n  ]\n}\n");
+		return std::fclose(File) == 0;
+	}
+
+	int RunSuite(const std::vector<std::string>& Families, const std::vector<int32_t>& Sizes,
+	             const FSolverSettings& Settings, const int32_t MaxIterations, const char* CsvPath,
+	             const char* JsonPath)
+	{
+		std::vector<FSuiteResult> Results;
+		std::printf("%-11s %7s %7s %6s %4s %9s %9s %9s %9s %11s %8s %7s\n", "family", "nodes", "edges", "iters",
+		            "conv", "ms/iter", "repulse", "attract", "apply", "solver KB", "edge cv", "stress");
+		for (const FGraphFamily& Family : GraphFamilies)
+		{
+			if (!Families.empty() && std::find(Families.begin(), Families.end(), Family.Name) == Families.end())
+				continue;
+
+			for (const int32_t NumNodes : Sizes)
+			{
+				const FSuiteResult& Result = Results.emplace_back(
+					RunSuiteCase(Family, NumNodes, Settings, MaxIterations));
+				std::printf("%-11s %7d %7d %6d %4s %9.3f %9.3f %9.3f %9.3f %11zu %8.4f %7.4f\n", Result.Family.c_str(),
+				            Result.NumNodes, Result.NumEdges, Result.NumIterations, Result.bConverged ? "yes" : "no",
+				            Result.MsPerIteration, Result.RepulsionMs, Result.AttractionMs, Result.ApplyMs,
+				            Result.PeakSolverBytes / 1024, Result.EdgeLengthCv, Result.Stress);
+				std::fflush(stdout);
+			}
+		}
+
+		if (Results.empty())
+		{
+			std::printf("No graph family matched.\n");
+			return 1;
+		}
+		if (CsvPath && !WriteCsv(CsvPath, Results))
+		{
+			std::printf("Failed to write %s\n", CsvPath);
+			return 1;
+		}
+		if (JsonPath && !WriteJson(JsonPath, Results, Settings, MaxIterations))
+		{
+			std::printf("Failed to write %s\n", JsonPath);
+			return 1;
+		}
+		return 0;
+	}
+
+	template <typename FunctionType>
+	double TimeMs(const int32_t NumRepeats, FunctionType&& Function)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+		for (int32_t Repeat = 0; Repeat < NumRepeats; ++Repeat)
+		{
+			Function();
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count()
+			/ std::max(NumRepeats, 1);
+	}
+
+	// Where the spatial hash grid overtakes exact and Barnes-Hut repulsion depends on how many nodes share a
+	// cutoff-sized cell: sparse layouts only touch a handful of neighbors, dense ones degrade to all pairs.
+	void RunDensitySweep(const float Cutoff, const float Theta, const int32_t NumRepeats)
+	{
+		const float KSquared = 15.f * 15.f;
+		std::printf("%8s %10s %12s %12s %12s %10s\n", "nodes", "density", "exact ms", "barneshut ms", "grid ms",
+		            "fastest");
+
+		for (const int32_t NumNodes : {1000, 5000, 20000})
+		{
+			for (const float Density : {0.01f, 0.1f, 1.f, 10.f, 100.f})
+			{
+				// Density = NumNodes * Cutoff^3 / (2 * HalfExtent)^3
+				const float HalfExtent = 0.5f * Cutoff * std::cbrt(static_cast<float>(NumNodes) / Density);
+				FLayoutBuffers Positions, Forces;
+				Standalone::RandomizePositions(Positions, NumNodes, HalfExtent, 3);
+				Forces.SetNumZeroed(NumNodes);
+
+				const double ExactMs = TimeMs(NumRepeats, [&]
+				{
+					FLayoutKernels::RepulsionSimd(Positions, 0, NumNodes, KSquared, Cutoff, Forces);
+				});
+
+				FBarnesHutOctree Octree;
+				const double BarnesHutMs = TimeMs(NumRepeats, [&]
+				{
+					Octree.Build(Positions);
+					for (int32_t v = 0; v < NumNodes; ++v)
+					{
+						Forces.Add(v, Octree.ComputeRepulsion(v, KSquared, Theta, Cutoff));
+					}
+				});
+
+				FSpatialHashGrid Grid;
+				const double GridMs = TimeMs(NumRepeats, [&]
+				{
+					Grid.Build(Positions, Cutoff);
+					for (int32_t v = 0; v < NumNodes; ++v)
+					{
+						Forces.Add(v, Grid.ComputeRepulsion(v, KSquared));
+					}
+				});
+
+				const double FastestMs = std::min({ExactMs, BarnesHutMs, GridMs});
+				const char* Fastest = FastestMs == GridMs ? "grid" : FastestMs == BarnesHutMs ? "barneshut" : "exact";
+				std::printf("%8d %10g %12.3f %12.3f %12.3f %10s\n", NumNodes, Density, ExactMs, BarnesHutMs, GridMs,
+				            Fastest);
+			}
+		}
+	}
+}
+
+int main(int Argc, char** Argv)
+{
+	int32_t NumNodes = 10000;
+	int32_t Degree = 3;
+	int32_t NumIterations = 20;
+	int32_t NumTasks = 0;
+	float HalfExtent = 0.f;
+	bool bSweep = false;
+	bool bSuite = false;
+	std::vector<std::string> Families;
+	std::vector<int32_t> Sizes = {100, 1000, 10000, 100000};
+	int32_t MaxIterations = 500;
+	const char* CsvPath = nullptr;
+	const char* JsonPath = nullptr;
+	FSolverSettings Settings;
+
+	for (int32_t i = 1; i < Argc; ++i)
+	{
+		const bool bHasValue = i + 1 < Argc;
+		if (!std::strcmp(Argv[i], "--nodes") && bHasValue)
+			NumNodes = std::atoi(Argv[++i]);
+		else if (!std::strcmp(Argv[i], "--degree") && bHasValue)
+			Degree = std::atoi(Argv[++i]);
+		else if (!std::strcmp(Argv[i], "--iterations") && bHasValue)
+			NumIterations = std::atoi(Argv[++i]);
+		else if (!std::strcmp(Argv[i], "--method") && bHasValue)
+		{
+			const char* Method = Argv[++i];
+			if (!std::strcmp(Method, "exact"))
+				Settings.RepulsionMethod = ERepulsionMethod::Exact;
+			else if (!std::strcmp(Method, "barneshut"))
+				Settings.RepulsionMethod = ERepulsionMethod::BarnesHut;
+			else if (!std::strcmp(Method, "grid"))
+				Settings.RepulsionMethod = ERepulsionMethod::SpatialHash;
+			else
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+		else if (!std::strcmp(Argv[i], "--cutoff") && bHasValue)
+			Settings.RepulsionCutoff = static_cast<float>(std::atof(Argv[++i]));
+		else if (!std::strcmp(Argv[i], "--extent") && bHasValue)
+			HalfExtent = static_cast<float>(std::atof(Argv[++i]));
+		else if (!std::strcmp(Argv[i], "--sweep"))
+			bSweep = true;
+		else if (!std::strcmp(Argv[i], "--suite"))
+			bSuite = true;
+		else if (!std::strcmp(Argv[i], "--generators") && bHasValue)
+			Families = SplitList(Argv[++i]);
+		else if (!std::strcmp(Argv[i], "--sizes") && bHasValue)
+		{
+			Sizes.clear();
+			for (const std::string& Size : SplitList(Argv[++i]))
+			{
+				Sizes.push_back(std::atoi(Size.c_str()));
+			}
+		}
+		else if (!std::strcmp(Argv[i], "--max-iterations") && bHasValue)
+			MaxIterations = std::atoi(Argv[++i]);
+		else if (!std::strcmp(Argv[i], "--csv") && bHasValue)
+			CsvPath = Argv[++i];
+		else if (!std::strcmp(Argv[i], "--json") && bHasValue)
+			JsonPath = Argv[++i];
+		else if (!std::strcmp(Argv[i], "--theta") && bHasValue)
+			Settings.Theta = static_cast<float>(std::atof(Argv[++i]));
+		else if (!std::strcmp(Argv[i], "--tasks") && bHasValue)
+			NumTasks = std::atoi(Argv[++i]);
+		else if (!std::strcmp(Argv[i], "--scalar"))
+			Settings.bUseSimd = false;
+		else if (!std::strcmp(Argv[i], "--stress"))
+			Settings.Algorithm = ELayoutAlgorithm::StressMajorization;
+		else if (!std::strcmp(Argv[i], "--pivots") && bHasValue)
+			Settings.StressPivots = std::atoi(Argv[++i]);
+		else
+		{
+			PrintUsage();
+			return !std::strcmp(Argv[i], "--help") ? 0 : 1;
+		}
+	}
+
+	if (bSweep)
+	{
+		RunDensitySweep(Settings.RepulsionCutoff, Settings.Theta, std::max(NumIterations / 10, 1));
+		return 0;
+	}
+
+	Settings.NumTasks = NumTasks > 0 ? NumTasks : static_cast<int32_t>(std::thread::hardware_concurrency());
+
+	if (bSuite)
+		return RunSuite(Families, Sizes, Settings, MaxIterations, CsvPath, JsonPath);
+
+	FFruchtermanReingoldSolver Solver;
+	Solver.SetSettings(Settings);
+	Solver.SetParallelFor(MakeThreadParallelFor());
+	Solver.SetGraph(NumNodes, Standalone::RandomEdges(NumNodes, Degree, 1));
+	if (HalfExtent <= 0.f)
+	{
+		HalfExtent = 20.f * std::sqrt(static_cast<float>(NumNodes));
+	}
+	Standalone::RandomizePositions(Solver.GetPositions(), NumNodes, HalfExtent, 2);
+
+	const auto Start = std::chrono::steady_clock::now();
+	for (int32_t Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		Solver.Step();
+	}
+	const double TotalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+	std::printf("nodes=%d edges=%d tasks=%d algorithm=%d method=%d theta=%g cutoff=%g simd=%d iterations=%d "
+	            "ms/iteration=%.3f\n",
+	            NumNodes, Solver.GetGraph().GetNumEdges(), Settings.NumTasks, static_cast<int32_t>(Settings.Algorithm),
+	            static_cast<int32_t>(Settings.RepulsionMethod),
+	            Settings.Theta, Settings.RepulsionCutoff, Settings.bUseSimd ? 1 : 0, NumIterations,
+	            TotalMs / std::max(NumIterations, 1));
+	return 0;
+}
@@ -0,0 +1,741 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Headless unit tests for the layout core. Returns non-zero if any check fails.
+
+#include "StandaloneCommon.h"
+#include "Layout/BarnesHutOctree.h"
+#include "Layout/LayoutCache.h"
+#include "Layout/FruchtermanReingoldSolver.h"
+#include "Layout/LayoutGraph.h"
+#include "Layout/LayoutKernels.h"
+#include "Layout/SpatialHashGrid.h"
+#include "Layout/TripleBuffer.h"
+
+#include <cstdio>
+#include <thread>
+
+using namespace ForceDirected;
+
+namespace
+{
+	int32_t GNumFailures = 0;
+
+	void Expect(const bool bCondition, const char* Description)
+	{
+		if (!bCondition)
+		{
+			std::printf("  FAILED: %s\n", Description);
+			++GNumFailures;
+		}
+	}
+
+	bool IsFinite(const FLayoutBuffers& Buffers)
+	{
+		for (int32_t i = 0; i < Buffers.Num(); ++i)
+		{
+			const FVec3 Value = Buffers.Get(i);
+			if (!std::isfinite(Value.X) || !std::isfinite(Value.Y) || !std::isfinite(Value.Z))
+				return false;
+		}
+		return true;
+	}
+
+	// Largest per-node difference between two force buffers, relative to the reference magnitude
+	float MaxRelativeError(const FLayoutBuffers& Reference, const FLayoutBuffers& Other)
+	{
+		float MaxError = 0.f;
+		for (int32_t i = 0; i < Reference.Num(); ++i)
+		{
+			const FVec3 Expected = Reference.Get(i);
+			MaxError = std::max(MaxError, (Other.Get(i) - Expected).Size() / std::max(Expected.Size(), 1.f));
+		}
+		return MaxError;
+	}
+
+	void TestSimdMatchesScalar()
+	{
+		// Odd node count exercises the remainder loop
+		FLayoutBuffers Positions;
+		Standalone::RandomizePositions(Positions, 1003, 800.f, 1);
+
+		const float Error = FLayoutKernels::CompareRepulsionKernels(Positions, 225.f, 1000.f);
+		std::printf("  SIMD available: %d, max relative error: %g\n", FLayoutKernels::IsSimdAvailable(), Error);
+		Expect(Error < 1.e-3f, "SIMD repulsion agrees with the scalar reference");
+	}
+
+	void TestOctreeExactWithZeroTheta()
+	{
+		FLayoutBuffers Positions;
+		Standalone::RandomizePositions(Positions, 500, 400.f, 2);
+
+		FLayoutBuffers Exact, Approximate;
+		Exact.SetNumZeroed(Positions.Num());
+		Approximate.SetNumZeroed(Positions.Num());
+		FLayoutKernels::RepulsionScalar(Positions, 0, Positions.Num(), 225.f, 1000.f, Exact);
+
+		FBarnesHutOctree Octree;
+		Octree.Build(Positions);
+		for (int32_t v = 0; v < Positions.Num(); ++v)
+		{
+			Approximate.Add(v, Octree.ComputeRepulsion(v, 225.f, 0.f, 1000.f));
+		}
+		Expect(MaxRelativeError(Exact, Approximate) < 1.e-3f, "Octree with theta = 0 matches exact repulsion");
+	}
+
+	void TestOctreeApproximation()
+	{
+		FLayoutBuffers Positions;
+		Standalone::RandomizePositions(Positions, 2000, 2000.f, 3);
+
+		FLayoutBuffers Exact, Approximate;
+		Exact.SetNumZeroed(Positions.Num());
+		Approximate.SetNumZeroed(Positions.Num());
+		FLayoutKernels::RepulsionScalar(Positions, 0, Positions.Num(), 225.f, 1.e9f, Exact);
+
+		FBarnesHutOctree Octree;
+		Octree.Build(Positions);
+		double SumError = 0.0;
+		for (int32_t v = 0; v < Positions.Num(); ++v)
+		{
+			Approximate.Add(v, Octree.ComputeRepulsion(v, 225.f, 0.5f, 1.e9f));
+			const FVec3 Expected = Exact.Get(v);
+			SumError += (Approximate.Get(v) - Expected).Size() / std::max(Expected.Size(), 1.f);
+		}
+		const double MeanError = SumError / Positions.Num();
+		std::printf("  theta = 0.5 mean relative error: %g\n", MeanError);
+		Expect(MeanError < 0.05, "Octree with theta = 0.5 stays within 5% on average");
+	}
+
+	void TestOctreeCoincidentNodes()
+	{
+		FLayoutBuffers Positions;
+		Positions.SetNumZeroed(64);
+
+		FBarnesHutOctree Octree;
+		Octree.Build(Positions);
+		const FVec3 Force = Octree.ComputeRepulsion(0, 225.f, 0.5f, 1000.f);
+		Expect(Force.IsZero(), "Coincident nodes don't produce forces");
+	}
+
+	void TestSpatialHashMatchesExact()
+	{
+		// Spread across many cells on both sides of the origin, plus a clump sharing one cell
+		FLayoutBuffers Positions;
+		Standalone::RandomizePositions(Positions, 3000, 3000.f, 9);
+		for (int32_t v = 0; v < 50; ++v)
+		{
+			Positions.Set(v, FVec3(10.f + static_cast<float>(v), -20.f, 5.f));
+		}
+
+		constexpr float Cutoff = 300.f;
+		FLayoutBuffers Exact, Grid;
+		Exact.SetNumZeroed(Positions.Num());
+		Grid.SetNumZeroed(Positions.Num());
+		FLayoutKernels::RepulsionScalar(Positions, 0, Positions.Num(), 225.f, Cutoff, Exact);
+
+		FSpatialHashGrid HashGrid;
+		HashGrid.Build(Positions, Cutoff);
+		for (int32_t v = 0; v < Positions.Num(); ++v)
+		{
+			Grid.Add(v, HashGrid.ComputeRepulsion(v, 225.f));
+		}
+
+		std::printf("  %d occupied cells, %zu bytes\n", HashGrid.GetNumOccupiedCells(), HashGrid.GetAllocatedSize());
+		Expect(MaxRelativeError(Exact, Grid) < 1.e-3f, "Spatial hash repulsion matches exact repulsion within the cutoff");
+		Expect(HashGrid.GetNumOccupiedCells() > 1 && HashGrid.GetNumOccupiedCells() <= Positions.Num(),
+		       "Nodes are spread over several cells");
+	}
+
+	void TestGraphCompilesToSortedRows()
+	{
+		// Duplicates in either direction collapse into one edge
+		FLayoutGraph Graph;
+		Graph.Build(5, {{3, 0}, {0, 3}, {0, 1}, {4, 0}, {2, 1}, {1, 2}, {3, 3}, {0, 7}});
+
+		Expect(Graph.GetNumEdges() == 4, "Duplicate, self and out of range edges are removed");
+		Expect(Graph.GetNeighbors().size() == 8, "Every edge appears in both rows");
+
+		const std::vector<int32_t> Expected0 = {1, 3, 4};
+		Expect(std::vector<int32_t>(Graph.NeighborsBegin(0), Graph.NeighborsEnd(0)) == Expected0,
+		       "Rows are sorted ascending");
+		const std::vector<int32_t> Expected1 = {0, 2};
+		Expect(std::vector<int32_t>(Graph.NeighborsBegin(1), Graph.NeighborsEnd(1)) == Expected1,
+		       "Smaller and larger neighbors interleave in order");
+		Expect(Graph.GetDegree(4) == 1, "Degree comes from the offsets");
+
+		bool bEdgesNormalized = true;
+		for (const FEdge& Edge : Graph.GetEdges())
+		{
+			bEdgesNormalized &= Edge.A < Edge.B;
+		}
+		Expect(bEdgesNormalized, "Edges are stored with A < B");
+		Expect(Graph.GetAllocatedSize() >= (6 + 8) * sizeof(int32_t) + 4 * sizeof(FEdge), "Memory use is reported");
+	}
+
+	void TestSetGraphDropsInvalidEdges()
+	{
+		FFruchtermanReingoldSolver Solver;
+		Solver.SetGraph(3, {{0, 1}, {1, 1}, {2, 5}, {-1, 0}, {1, 2}});
+		Expect(Solver.GetGraph().GetNumEdges() == 2, "Self loops and out of range edges are dropped");
+		Expect(Solver.GetPositions().Num() == 3, "Positions are sized to the node count");
+	}
+
+	void TestSolverUntanglesPath()
+	{
+		// A path squashed onto a tiny cube should spread out to roughly K per edge
+		constexpr int32_t NumNodes = 20;
+		std::vector<FEdge> Edges;
+		for (int32_t i = 1; i < NumNodes; ++i)
+		{
+			Edges.push_back({i - 1, i});
+		}
+
+		FFruchtermanReingoldSolver Solver;
+		Solver.SetGraph(NumNodes, Edges);
+		Standalone::RandomizePositions(Solver.GetPositions(), NumNodes, 5.f, 4);
+		for (int32_t Iteration = 0; Iteration < 500; ++Iteration)
+		{
+			Solver.Step();
+		}
+
+		Expect(IsFinite(Solver.GetPositions()), "Positions stay finite");
+
+		float MeanEdgeLength = 0.f;
+		for (const FEdge& Edge : Solver.GetGraph().GetEdges())
+		{
+			MeanEdgeLength += (Solver.GetPositions().Get(Edge.A) - Solver.GetPositions().Get(Edge.B)).Size();
+		}
+		MeanEdgeLength /= static_cast<float>(Solver.GetGraph().GetNumEdges());
+		std::printf("  mean edge length: %g (K = %g)\n", MeanEdgeLength, Solver.GetSettings().KConstant);
+		Expect(MeanEdgeLength > 0.5f * Solver.GetSettings().KConstant
+		       && MeanEdgeLength < 4.f * Solver.GetSettings().KConstant,
+		       "Edge lengths settle near K");
+		Expect(Solver.GetTemperature() == Solver.GetSettings().MinTemperature, "Temperature cools to its minimum");
+	}
+
+	void TestSolverConverges()
+	{
+		constexpr int32_t NumNodes = 50;
+		FFruchtermanReingoldSolver Solver;
+		Solver.SetGraph(NumNodes, Standalone::RandomEdges(NumNodes, 2, 7));
+		Standalone::RandomizePositions(Solver.GetPositions(), NumNodes, 50.f, 8);
+
+		int32_t Iteration = 0;
+		for (; Iteration < 5000 && !Solver.IsConverged(); ++Iteration)
+		{
+			Solver.Step();
+		}
+		std::printf("  converged after %d iterations, max displacement %g, max drift %g, energy %g\n", Iteration,
+		            Solver.GetMaxDisplacement(), Solver.GetMaxDrift(), Solver.GetEnergy());
+		Expect(Solver.IsConverged(), "Layout converges");
+		Expect(Solver.GetMaxDrift() < Solver.GetSettings().ConvergenceThreshold, "Last step stayed below the threshold");
+
+		const FStepTimings& Timings = Solver.GetLastStepTimings();
+		Expect(Timings.Repulsion >= 0.0 && Timings.Attraction >= 0.0 && Timings.Apply >= 0.0,
+		       "Phase timings are not negative");
+		Expect(Timings.Repulsion + Timings.Attraction + Timings.Apply > 0.0, "Last step was timed");
+
+		Solver.ResetConvergence();
+		Expect(!Solver.IsConverged(), "Resetting convergence requires new quiet steps");
+	}
+
+	// Number of connected components, by flood fill over the compiled graph
+	int32_t CountComponents(const FLayoutGraph& Graph)
+	{
+		std::vector<int32_t> Component(Graph.GetNumNodes(), -1);
+		std::vector<int32_t> Stack;
+		int32_t NumComponents = 0;
+		for (int32_t Root = 0; Root < Graph.GetNumNodes(); ++Root)
+		{
+			if (Component[Root] >= 0)
+				continue;
+
+			Component[Root] = NumComponents;
+			Stack.push_back(Root);
+			while (!Stack.empty())
+			{
+				const int32_t v = Stack.back();
+				Stack.pop_back();
+				for (const int32_t* u = Graph.NeighborsBegin(v); u != Graph.NeighborsEnd(v); ++u)
+				{
+					if (Component[*u] < 0)
+					{
+						Component[*u] = NumComponents;
+						Stack.push_back(*u);
+					}
+				}
+			}
+			++NumComponents;
+		}
+		return NumComponents;
+	}
+
+	void TestGraphGenerators()
+	{
+		constexpr int32_t NumNodes = 1000;
+		FLayoutGraph Graph;
+
+		Graph.Build(NumNodes, Standalone::GridEdges(NumNodes));
+		Expect(CountComponents(Graph) == 1, "Grid is connected");
+		Expect(Graph.GetNumEdges() < 2 * NumNodes, "Grid has at most two edges per node");
+
+		Graph.Build(NumNodes, Standalone::TreeEdges(NumNodes, 3));
+		Expect(CountComponents(Graph) == 1 && Graph.GetNumEdges() == NumNodes - 1, "Tree is a spanning tree");
+		Expect(Graph.GetDegree(0) == 3, "Tree root has Branching children");
+
+		Graph.Build(NumNodes, Standalone::ScaleFreeEdges(NumNodes, 2, 1));
+		Expect(CountComponents(Graph) == 1, "Scale-free graph is connected");
+		int32_t MaxDegree = 0;
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			MaxDegree = std::max(MaxDegree, Graph.GetDegree(v));
+		}
+		Expect(MaxDegree > 10 * 4, "Scale-free graph grows hubs far above the average degree");
+
+		Graph.Build(NumNodes, Standalone::ErdosRenyiEdges(NumNodes, 3.f, 1));
+		Expect(Graph.GetNumEdges() > NumNodes * 14 / 10 && Graph.GetNumEdges() <= NumNodes * 3 / 2,
+		       "Erdos-Renyi graph has close to the requested average degree");
+
+		Graph.Build(NumNodes, Standalone::ClusterEdges(NumNodes, 8, 3, 1));
+		Expect(CountComponents(Graph) == 8, "Clusters are connected inside and disconnected from each other");
+	}
+
+	void TestParallelMatchesSingleTask()
+	{
+		constexpr int32_t NumNodes = 777;
+		const std::vector<FEdge> Edges = Standalone::RandomEdges(NumNodes, 3, 5);
+
+		for (const ERepulsionMethod Method : {ERepulsionMethod::Exact, ERepulsionMethod::BarnesHut, ERepulsionMethod::SpatialHash})
+		{
+			FFruchtermanReingoldSolver Single, Parallel;
+			FSolverSettings Settings;
+			Settings.RepulsionMethod = Method;
+			Settings.Theta = 0.7f;
+			Settings.RepulsionCutoff = 200.f;
+			Single.SetSettings(Settings);
+			Settings.NumTasks = 8;
+			Parallel.SetSettings(Settings);
+			Parallel.SetParallelFor(MakeThreadParallelFor());
+
+			Single.SetGraph(NumNodes, Edges);
+			Parallel.SetGraph(NumNodes, Edges);
+			Standalone::RandomizePositions(Single.GetPositions(), NumNodes, 300.f, 6);
+			Parallel.GetPositions() = Single.GetPositions();
+
+			for (int32_t Iteration = 0; Iteration < 5; ++Iteration)
+			{
+				Single.Step();
+				Parallel.Step();
+			}
+
+			Expect(MaxRelativeError(Single.GetPositions(), Parallel.GetPositions()) < 1.e-3f,
+			       "Parallel step matches single task step");
+		}
+	}
+
+	void TestTopologyHashIsCanonical()
+	{
+		// A 4-cycle with a chord, built once as is and once with every node relabeled by Permutation
+		const std::vector<FEdge> Edges = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {0, 2}};
+		const std::vector<int32_t> Permutation = {2, 0, 3, 1};
+		std::vector<FEdge> PermutedEdges;
+		for (auto It = Edges.rbegin(); It != Edges.rend(); ++It)
+		{
+			PermutedEdges.push_back({Permutation[It->B], Permutation[It->A]});
+		}
+
+		FLayoutGraph Graph, Permuted;
+		Graph.Build(4, Edges);
+		Permuted.Build(4, PermutedEdges);
+
+		// Mapping the permuted graph's nodes back to the original labels gives the same canonical graph
+		std::vector<int32_t> Inverse(4);
+		for (int32_t v = 0; v < 4; ++v)
+		{
+			Inverse[Permutation[v]] = v;
+		}
+		Expect(HashGraphTopology(Graph, {}) == HashGraphTopology(Permuted, Inverse),
+		       "Relabeled graph hashes the same under its canonical numbering");
+		Expect(HashGraphTopology(Graph, {}) != HashGraphTopology(Permuted, {}),
+		       "Different numbering hashes differently");
+		Expect(HashGraphTopology(Graph, {}, 1) != HashGraphTopology(Graph, {}, 2), "Seed takes part in the hash");
+
+		FLayoutGraph WithoutChord;
+		WithoutChord.Build(4, {{0, 1}, {1, 2}, {2, 3}, {3, 0}});
+		Expect(HashGraphTopology(Graph, {}) != HashGraphTopology(WithoutChord, {}), "Missing edge changes the hash");
+
+		FLayoutHasher A, B;
+		A.AddString("ab");
+		A.AddString("c");
+		B.AddString("a");
+		B.AddString("bc");
+		Expect(A.Get() != B.Get(), "Strings do not run into each other");
+	}
+
+	void TestLayoutCacheWarmStart()
+	{
+		constexpr int32_t NumNodes = 60;
+		const std::vector<FEdge> Edges = Standalone::RandomEdges(NumNodes, 2, 9);
+
+		FFruchtermanReingoldSolver Cold;
+		Cold.SetGraph(NumNodes, Edges);
+		Standalone::RandomizePositions(Cold.GetPositions(), NumNodes, 50.f, 10);
+		int32_t ColdIterations = 0;
+		for (; ColdIterations < 5000 && !Cold.IsConverged(); ++ColdIterations)
+		{
+			Cold.Step();
+		}
+
+		const uint64_t Key = HashGraphTopology(Cold.GetGraph(), {});
+		FLayoutCache Cache;
+		Cache.Store(Key, Cold.GetPositions());
+
+		std::vector<uint8_t> Bytes;
+		Cache.Save(Bytes);
+		FLayoutCache Loaded;
+		Expect(Loaded.Load(Bytes) && Loaded.Num() == 1, "Saved cache loads back");
+
+		FLayoutBuffers Cached;
+		Expect(!Loaded.Find(Key, NumNodes + 1, Cached), "Entry for another node count is not used");
+		Expect(!Loaded.Find(Key + 1, NumNodes, Cached), "Unknown key misses");
+		Expect(Loaded.Find(Key, NumNodes, Cached) && MaxRelativeError(Cold.GetPositions(), Cached) == 0.f,
+		       "Positions survive the round trip");
+
+		std::vector<uint8_t> Truncated(Bytes.begin(), Bytes.end() - 1);
+		Expect(!Loaded.Load(Truncated) && Loaded.Num() == 0, "Truncated cache is rejected");
+		std::vector<uint8_t> OtherVersion = Bytes;
+		++OtherVersion[4];
+		Expect(!Loaded.Load(OtherVersion), "Cache from another version is rejected");
+
+		// Starting from the settled layout at a low temperature has almost nothing left to do
+		FFruchtermanReingoldSolver Warm;
+		Warm.SetGraph(NumNodes, Edges);
+		Warm.GetPositions() = Cached;
+		Warm.SetTemperature(Warm.GetSettings().MinTemperature);
+		int32_t WarmIterations = 0;
+		for (; WarmIterations < 5000 && !Warm.IsConverged(); ++WarmIterations)
+		{
+			Warm.Step();
+		}
+		std::printf("  cold start converged after %d iterations, warm start after %d (%zu byte cache)\n",
+		            ColdIterations, WarmIterations, Bytes.size());
+		Expect(Warm.IsConverged() && WarmIterations < ColdIterations, "Warm start converges sooner");
+	}
+
+	void TestLayoutCacheEviction()
+	{
+		// Every entry holds 10 nodes, 120 bytes, so three of them fit
+		constexpr int32_t NumNodes = 10;
+		FLayoutBuffers Positions;
+		Standalone::RandomizePositions(Positions, NumNodes, 50.f, 11);
+		const size_t EntryBytes = static_cast<size_t>(NumNodes) * 3 * sizeof(float);
+
+		FLayoutCache Cache(3 * EntryBytes);
+		Cache.Store(1, Positions);
+		Cache.Store(2, Positions);
+		Cache.Store(3, Positions);
+		Expect(Cache.Num() == 3 && Cache.GetNumBytes() == 3 * EntryBytes, "Entries up to the cap are kept");
+
+		// Finding 1 makes 2 the least recently used entry
+		FLayoutBuffers Found;
+		Expect(Cache.Find(1, NumNodes, Found), "Stored entry is found");
+		Cache.Store(4, Positions);
+		Expect(Cache.Num() == 3 && Cache.GetNumBytes() <= Cache.GetMaxBytes(), "Storing past the cap evicts");
+		Expect(!Cache.Find(2, NumNodes, Found), "Least recently used entry is evicted");
+		Expect(Cache.Find(1, NumNodes, Found) && Cache.Find(3, NumNodes, Found) && Cache.Find(4, NumNodes, Found),
+		       "Recently used entries stay");
+
+		// Replacing an entry doesn't count its old positions twice
+		Cache.Store(4, Positions);
+		Expect(Cache.Num() == 3 && Cache.GetNumBytes() == 3 * EntryBytes, "Replacing an entry keeps the others");
+
+		FLayoutBuffers Large;
+		Standalone::RandomizePositions(Large, 4 * NumNodes, 50.f, 12);
+		Cache.Store(5, Large);
+		Expect(!Cache.Find(5, 4 * NumNodes, Found) && Cache.Num() == 3, "Entry larger than the cap is not kept");
+
+		// Recency survives a round trip, and a smaller cache keeps the most recently used entries
+		std::vector<uint8_t> Bytes;
+		Cache.Save(Bytes);
+		FLayoutCache Smaller(EntryBytes);
+		Expect(Smaller.Load(Bytes) && Smaller.Num() == 1 && Smaller.Find(4, NumNodes, Found),
+		       "Loading into a smaller cache keeps the most recent entry");
+
+		Cache.SetMaxBytes(2 * EntryBytes);
+		Expect(Cache.Num() == 2 && !Cache.Find(1, NumNodes, Found), "Lowering the cap evicts right away");
+	}
+
+	void TestIncrementalUpdateStaysLocal()
+	{
+		// A 20 x 20 lattice, so hop distance and spatial distance agree
+		constexpr int32_t Side = 20;
+		constexpr int32_t NumNodes = Side * Side;
+		std::vector<FEdge> Edges;
+		for (int32_t Y = 0; Y < Side; ++Y)
+		{
+			for (int32_t X = 0; X < Side; ++X)
+			{
+				if (X + 1 < Side)
+					Edges.push_back({Y * Side + X, Y * Side + X + 1});
+				if (Y + 1 < Side)
+					Edges.push_back({Y * Side + X, (Y + 1) * Side + X});
+			}
+		}
+
+		FFruchtermanReingoldSolver Solver;
+		FSolverSettings Settings;
+		Settings.RepulsionCutoff = 100.f;
+		Solver.SetSettings(Settings);
+		Solver.SetGraph(NumNodes, Edges);
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			Solver.GetPositions().Set(v, FVec3(15.f * (v % Side), 15.f * (v / Side), 0.f));
+		}
+		for (int32_t Iteration = 0; Iteration < 5000 && !Solver.IsConverged(); ++Iteration)
+		{
+			Solver.Step();
+		}
+		const FLayoutBuffers Settled = Solver.GetPositions();
+
+		// Two new nodes hanging off a corner, one of them also tied to a node inside
+		std::vector<FEdge> NewEdges = Edges;
+		NewEdges.push_back({0, NumNodes});
+		NewEdges.push_back({NumNodes, NumNodes + 1});
+		NewEdges.push_back({NumNodes + 1, 1});
+		std::vector<int32_t> PreviousNodes(NumNodes + 2, InvalidIndex);
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			PreviousNodes[v] = v;
+		}
+
+		FLayoutBuffers HostPositions;
+		HostPositions.SetNumZeroed(NumNodes + 2);
+		const int32_t NumActive = Solver.UpdateGraph(NumNodes + 2, NewEdges, PreviousNodes, HostPositions);
+		std::printf("  %d of %d nodes relaxed locally\n", NumActive, NumNodes + 2);
+		Expect(Solver.IsRelaxingLocally() && NumActive > 2 && NumActive < NumNodes / 10,
+		       "Only the neighborhood of the change is relaxed");
+		Expect((Solver.GetPositions().Get(NumNodes) - Settled.Get(0)).Size() < 2.f * Settings.KConstant,
+		       "New node starts next to its placed neighbor");
+
+		int32_t Iteration = 0;
+		for (; Iteration < 5000 && !Solver.IsConverged(); ++Iteration)
+		{
+			Solver.Step();
+		}
+		std::printf("  local relayout converged after %d iterations\n", Iteration);
+		Expect(Solver.IsConverged() && !Solver.IsRelaxingLocally(), "Local relayout converges and ends");
+		Expect(IsFinite(Solver.GetPositions()), "Positions stay finite");
+
+		// Far away from the change nothing moved at all
+		const int32_t FarCorner = NumNodes - 1;
+		Expect(Solver.GetPositions().Get(FarCorner).X == Settled.Get(FarCorner).X
+		       && Solver.GetPositions().Get(FarCorner).Y == Settled.Get(FarCorner).Y,
+		       "Frozen nodes keep their positions");
+		Expect((Solver.GetPositions().Get(NumNodes) - Solver.GetPositions().Get(0)).Size() < 4.f * Settings.KConstant,
+		       "New node settles near its neighbor");
+	}
+
+	float MeanEdgeLength(const FFruchtermanReingoldSolver& Solver)
+	{
+		float Sum = 0.f;
+		for (const FEdge& Edge : Solver.GetGraph().GetEdges())
+		{
+			Sum += (Solver.GetPositions().Get(Edge.A) - Solver.GetPositions().Get(Edge.B)).Size();
+		}
+		return Sum / static_cast<float>(std::max(Solver.GetGraph().GetNumEdges(), 1));
+	}
+
+	void TestStressMajorization()
+	{
+		// A squashed path stretches out straight: all-pairs stress puts its ends (N - 1) * K apart
+		constexpr int32_t PathNodes = 20;
+		std::vector<FEdge> Path;
+		for (int32_t i = 1; i < PathNodes; ++i)
+		{
+			Path.push_back({i - 1, i});
+		}
+
+		FSolverSettings Settings;
+		Settings.Algorithm = ELayoutAlgorithm::StressMajorization;
+		FFruchtermanReingoldSolver Solver;
+		Solver.SetSettings(Settings);
+		Solver.SetGraph(PathNodes, Path);
+		Standalone::RandomizePositions(Solver.GetPositions(), PathNodes, 5.f, 4);
+
+		Solver.Step();
+		const double InitialStress = Solver.GetStressMajorization().ComputeStress(Solver.GetPositions(), Settings.KConstant);
+		int32_t Iteration = 1;
+		while (!Solver.IsConverged() && Iteration < 1000)
+		{
+			Solver.Step();
+			++Iteration;
+		}
+		const double FinalStress = Solver.GetStressMajorization().ComputeStress(Solver.GetPositions(), Settings.KConstant);
+
+		const float EndToEnd = (Solver.GetPositions().Get(0) - Solver.GetPositions().Get(PathNodes - 1)).Size();
+		std::printf("  path: end to end %g (expected %g), stress %g -> %g\n", EndToEnd,
+		            (PathNodes - 1) * Settings.KConstant, InitialStress, FinalStress);
+		Expect(!Solver.GetStressMajorization().IsSparse(), "Small graphs use all pairs");
+		Expect(Iteration == Settings.StressIterations, "Converges after StressIterations passes");
+		Expect(IsFinite(Solver.GetPositions()), "Path positions stay finite");
+		Expect(std::abs(EndToEnd - (PathNodes - 1) * Settings.KConstant) < 0.05f * (PathNodes - 1) * Settings.KConstant,
+		       "Path ends are (N - 1) * K apart");
+		Expect(FinalStress < 0.1 * InitialStress, "Stress drops during the passes");
+
+		// Pivots on a larger grid, split over tasks
+		constexpr int32_t GridNodes = 2500;
+		Settings.StressAllPairsNodes = 1000;
+		Settings.NumTasks = 4;
+		Solver.SetSettings(Settings);
+		Solver.SetParallelFor(MakeThreadParallelFor());
+		Solver.SetGraph(GridNodes, Standalone::GridEdges(GridNodes));
+		Standalone::RandomizePositions(Solver.GetPositions(), GridNodes, 50.f, 5);
+		while (!Solver.IsConverged())
+		{
+			Solver.Step();
+		}
+		std::printf("  grid: %d terms, mean edge length %g\n", Solver.GetStressMajorization().GetNumTerms(),
+		            MeanEdgeLength(Solver));
+		Expect(Solver.GetStressMajorization().IsSparse(), "Large graphs use pivots");
+		Expect(Solver.GetStressMajorization().GetNumTerms() < GridNodes * (Settings.StressPivots + 2),
+		       "Sparse terms grow linearly with the node count");
+		Expect(IsFinite(Solver.GetPositions()), "Grid positions stay finite");
+		Expect(MeanEdgeLength(Solver) > 0.7f * Settings.KConstant && MeanEdgeLength(Solver) < 1.5f * Settings.KConstant,
+		       "Grid edges settle near K");
+
+		// Disconnected clusters get finite distances and stay apart
+		constexpr int32_t ClusterNodes = 400;
+		Settings.StressAllPairsNodes = 2000;
+		Solver.SetSettings(Settings);
+		Solver.SetGraph(ClusterNodes, Standalone::ClusterEdges(ClusterNodes, 4, 2, 6));
+		Standalone::RandomizePositions(Solver.GetPositions(), ClusterNodes, 5.f, 7);
+		while (!Solver.IsConverged())
+		{
+			Solver.Step();
+		}
+		Expect(IsFinite(Solver.GetPositions()), "Cluster positions stay finite");
+		Expect(MeanEdgeLength(Solver) > 0.5f * Settings.KConstant && MeanEdgeLength(Solver) < 2.f * Settings.KConstant,
+		       "Cluster edges settle near K");
+
+		// Moving a node resumes halfway instead of starting over
+		Solver.ResetConvergence();
+		Expect(!Solver.IsConverged(), "Reset convergence continues the passes");
+		int32_t Resumed = 0;
+		while (!Solver.IsConverged())
+		{
+			Solver.Step();
+			++Resumed;
+		}
+		Expect(Resumed == Settings.StressIterations - Settings.StressIterations / 2, "Resumes from the halfway pass");
+	}
+
+	void TestStressMoreComponentsThanPivots()
+	{
+		// 60 disjoint pairs followed by isolated nodes, far more components than pivots
+		constexpr int32_t NumNodes = 2100;
+		std::vector<FEdge> Edges;
+		for (int32_t Pair = 0; Pair < 60; ++Pair)
+		{
+			Edges.push_back({2 * Pair, 2 * Pair + 1});
+		}
+
+		FSolverSettings Settings;
+		Settings.Algorithm = ELayoutAlgorithm::StressMajorization;
+		Settings.StressAllPairsNodes = 1000;
+		Settings.StressPivots = 50;
+		FFruchtermanReingoldSolver Solver;
+		Solver.SetSettings(Settings);
+		Solver.SetGraph(NumNodes, Edges);
+		Standalone::RandomizePositions(Solver.GetPositions(), NumNodes, 50.f, 9);
+		while (!Solver.IsConverged())
+		{
+			Solver.Step();
+		}
+
+		Expect(Solver.GetStressMajorization().IsSparse(), "Large graphs use pivots");
+		Expect(IsFinite(Solver.GetPositions()), "Nodes without a pivot stay finite");
+		Expect(MeanEdgeLength(Solver) > 0.5f * Settings.KConstant && MeanEdgeLength(Solver) < 2.f * Settings.KConstant,
+		       "Pairs without a pivot still settle near K");
+	}
+
+	void TestTripleBufferHandsOverLatest()
+	{
+		TTripleBuffer<int32_t> Buffer;
+		Expect(!Buffer.Update(), "Nothing to read before the first publish");
+
+		Buffer.GetWriteBuffer() = 1;
+		Buffer.Publish();
+		Buffer.GetWriteBuffer() = 2;
+		Buffer.Publish();
+		Expect(Buffer.Update() && Buffer.GetReadBuffer() == 2, "Reader skips to the newest published value");
+		Expect(!Buffer.Update() && Buffer.GetReadBuffer() == 2, "Read buffer stays valid until something new arrives");
+
+		// A writer running concurrently must never hand over a partially written or older buffer
+		constexpr int32_t NumPublishes = 20000;
+		constexpr int32_t NumValues = 256;
+		TTripleBuffer<std::vector<int32_t>> Snapshots;
+		std::thread Writer([&Snapshots]
+		{
+			for (int32_t Iteration = 1; Iteration <= NumPublishes; ++Iteration)
+			{
+				Snapshots.GetWriteBuffer().assign(NumValues, Iteration);
+				Snapshots.Publish();
+			}
+		});
+
+		bool bConsistent = true;
+		int32_t LastSeen = 0;
+		while (LastSeen < NumPublishes && bConsistent)
+		{
+			if (!Snapshots.Update())
+				continue;
+
+			const std::vector<int32_t>& Values = Snapshots.GetReadBuffer();
+			bConsistent = Values.size() == NumValues && Values.front() > LastSeen
+				&& std::all_of(Values.begin(), Values.end(), [&Values](const int32_t Value) { return Value == Values.front(); });
+			LastSeen = Values.front();
+		}
+		Writer.join();
+		Expect(bConsistent, "Concurrent reads see whole snapshots in publish order");
+	}
+}
+
+int main()
+{
+	struct FTest
+	{
+		const char* Name;
+		void (*Run)();
+	};
+	const FTest Tests[] = {
+		{"SimdMatchesScalar", TestSimdMatchesScalar},
+		{"OctreeExactWithZeroTheta", TestOctreeExactWithZeroTheta},
+		{"OctreeApproximation", TestOctreeApproximation},
+		{"OctreeCoincidentNodes", TestOctreeCoincidentNodes},
+		{"SpatialHashMatchesExact", TestSpatialHashMatchesExact},
+		{"GraphCompilesToSortedRows", TestGraphCompilesToSortedRows},
+		{"SetGraphDropsInvalidEdges", TestSetGraphDropsInvalidEdges},
+		{"SolverUntanglesPath", TestSolverUntanglesPath},
+		{"SolverConverges", TestSolverConverges},
+		{"GraphGenerators", TestGraphGenerators},
+		{"ParallelMatchesSingleTask", TestParallelMatchesSingleTask},
+		{"IncrementalUpdateStaysLocal", TestIncrementalUpdateStaysLocal},
+		{"StressMajorization", TestStressMajorization},
+		{"StressMoreComponentsThanPivots", TestStressMoreComponentsThanPivots},
+		{"TripleBufferHandsOverLatest", TestTripleBufferHandsOverLatest},
+		{"TopologyHashIsCanonical", TestTopologyHashIsCanonical},
+		{"LayoutCacheWarmStart", TestLayoutCacheWarmStart},
+		{"LayoutCacheEviction", TestLayoutCacheEviction},
+	};
+
+	for (const FTest& Test : Tests)
+	{
+		std::printf("[ RUN  ] %s\n", Test.Name);
+		const int32_t FailuresBefore = GNumFailures;
+		Test.Run();
+		std::printf("[ %s ] %s\n", GNumFailures == FailuresBefore ? " OK " : "FAIL", Test.Name);
+	}
+
+	std::printf("%d check(s) failed\n", GNumFailures);
+	return GNumFailures == 0 ? 0 : 1;
+}
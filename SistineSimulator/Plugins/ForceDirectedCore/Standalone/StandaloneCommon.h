@@ -0,0 +1,146 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Layout/LayoutTypes.h"
+
+#include <algorithm>
+#include <random>
+
+namespace ForceDirected::Standalone
+{
+	// Scatter positions uniformly in a cube of the given half extent
+	inline void RandomizePositions(FLayoutBuffers& Positions, const int32_t NumNodes, const float HalfExtent,
+	                               const uint32_t Seed)
+	{
+		std::mt19937 Rng(Seed);
+		std::uniform_real_distribution<float> Coordinate(-HalfExtent, HalfExtent);
+		Positions.SetNumZeroed(NumNodes);
+		for (int32_t i = 0; i < NumNodes; ++i)
+		{
+			Positions.Set(i, FVec3(Coordinate(Rng), Coordinate(Rng), Coordinate(Rng)));
+		}
+	}
+
+	// Random graph with roughly EdgesPerNode edges per node, plus a spanning path so it stays connected
+	inline std::vector<FEdge> RandomEdges(const int32_t NumNodes, const int32_t EdgesPerNode, const uint32_t Seed)
+	{
+		std::mt19937 Rng(Seed);
+		std::vector<FEdge> Edges;
+		if (NumNodes < 2)
+			return Edges;
+
+		std::uniform_int_distribution<int32_t> Node(0, NumNodes - 1);
+		Edges.reserve(static_cast<size_t>(NumNodes) * (EdgesPerNode + 1));
+		for (int32_t i = 1; i < NumNodes; ++i)
+		{
+			Edges.push_back({i - 1, i});
+		}
+		for (int64_t e = 0; e < static_cast<int64_t>(NumNodes) * (EdgesPerNode - 1) / 2; ++e)
+		{
+			Edges.push_back({Node(Rng), Node(Rng)});
+		}
+		return Edges;
+	}
+
+	// Synthetic graph families for the benchmark suite. Each one produces exactly NumNodes nodes.
+
+	// Square-ish 2D lattice, the last row may be partial
+	inline std::vector<FEdge> GridEdges(const int32_t NumNodes)
+	{
+		const int32_t Width = std::max(static_cast<int32_t>(std::ceil(std::sqrt(static_cast<double>(NumNodes)))), 1);
+		std::vector<FEdge> Edges;
+		Edges.reserve(static_cast<size_t>(NumNodes) * 2);
+		for (int32_t v = 0; v < NumNodes; ++v)
+		{
+			if ((v + 1) % Width != 0 && v + 1 < NumNodes)
+			{
+				Edges.push_back({v, v + 1});
+			}
+			if (v + Width < NumNodes)
+			{
+				Edges.push_back({v, v + Width});
+			}
+		}
+		return Edges;
+	}
+
+	// Erdos-Renyi G(n, m) with m = NumNodes * AverageDegree / 2 uniformly random pairs. Not necessarily connected.
+	inline std::vector<FEdge> ErdosRenyiEdges(const int32_t NumNodes, const float AverageDegree, const uint32_t Seed)
+	{
+		std::vector<FEdge> Edges;
+		if (NumNodes < 2)
+			return Edges;
+
+		std::mt19937 Rng(Seed);
+		std::uniform_int_distribution<int32_t> Node(0, NumNodes - 1);
+		const int64_t NumEdges = static_cast<int64_t>(NumNodes * AverageDegree * 0.5f);
+		Edges.reserve(NumEdges);
+		for (int64_t e = 0; e < NumEdges; ++e)
+		{
+			Edges.push_back({Node(Rng), Node(Rng)});
+		}
+		return Edges;
+	}
+
+	// Barabasi-Albert preferential attachment: every new node links to EdgesPerNode existing nodes picked
+	// proportionally to their degree, which gives a few heavy hubs and a power law degree distribution
+	inline std::vector<FEdge> ScaleFreeEdges(const int32_t NumNodes, const int32_t EdgesPerNode, const uint32_t Seed)
+	{
+		std::vector<FEdge> Edges;
+		if (NumNodes < 2)
+			return Edges;
+
+		std::mt19937 Rng(Seed);
+		// Every edge endpoint once, so a uniform pick from it is a degree weighted pick of a node
+		std::vector<int32_t> Endpoints;
+		Endpoints.reserve(static_cast<size_t>(NumNodes) * EdgesPerNode * 2);
+		Edges.reserve(static_cast<size_t>(NumNodes) * EdgesPerNode);
+
+		Edges.push_back({0, 1});
+		Endpoints.push_back(0);
+		Endpoints.push_back(1);
+		for (int32_t v = 2; v < NumNodes; ++v)
+		{
+			std::uniform_int_distribution<size_t> Pick(0, Endpoints.size() - 1);
+			for (int32_t e = 0; e < std::max(EdgesPerNode, 1); ++e)
+			{
+				const int32_t Target = Endpoints[Pick(Rng)];
+				Edges.push_back({v, Target});
+				Endpoints.push_back(v);
+				Endpoints.push_back(Target);
+			}
+		}
+		return Edges;
+	}
+
+	// Complete tree in breadth-first order, node v hangs below node (v - 1) / Branching
+	inline std::vector<FEdge> TreeEdges(const int32_t NumNodes, const int32_t Branching)
+	{
+		std::vector<FEdge> Edges;
+		Edges.reserve(std::max(NumNodes - 1, 0));
+		for (int32_t v = 1; v < NumNodes; ++v)
+		{
+			Edges.push_back({(v - 1) / std::max(Branching, 1), v});
+		}
+		return Edges;
+	}
+
+	// NumClusters connected random graphs of equal size with no edges between them
+	inline std::vector<FEdge> ClusterEdges(const int32_t NumNodes, const int32_t NumClusters,
+	                                       const int32_t EdgesPerNode, const uint32_t Seed)
+	{
+		std::vector<FEdge> Edges;
+		const int32_t Clusters = std::clamp(NumClusters, 1, std::max(NumNodes, 1));
+		for (int32_t Cluster = 0; Cluster < Clusters; ++Cluster)
+		{
+			const int32_t Begin = static_cast<int32_t>(static_cast<int64_t>(NumNodes) * Cluster / Clusters);
+			const int32_t End = static_cast<int32_t>(static_cast<int64_t>(NumNodes) * (Cluster + 1) / Clusters);
+			for (const FEdge& Edge : RandomEdges(End - Begin, EdgesPerNode, Seed + Cluster))
+			{
+				Edges.push_back({Begin + Edge.A, Begin + Edge.B});
+			}
+		}
+		return Edges;
+	}
+}
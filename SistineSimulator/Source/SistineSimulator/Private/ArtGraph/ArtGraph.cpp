@@ -2,87 +2,210 @@
 
 #include "ArtGraph/ArtGraph.h"
 #include "ArtGraph/ArtGraphSubsystem.h"
+#include "UObject/AssetRegistryTagsContext.h"
+#include "UObject/ObjectSaveContext.h"
 
-TArray<TArray<FGameplayTag>> UGraphElement::GetAdjacencyList() const
+const FName UGraphElement::ReferencedElementsTag(TEXT("ArtGraphReferencedElements"));
+
+void UGraphElement::EnsureAdjacencyListUpToDate()
 {
+	if (!bAdjacencyListDirty)
+		return;
+
+	// Let the subsystem bring referenced graphs up to date first
+	UArtGraphSubsystem *Subsystem = GEngine ? GEngine->GetEngineSubsystem<UArtGraphSubsystem>() : nullptr;
+	if (Subsystem)
+	{
+		Subsystem->RebuildAdjacencyList(this);
+	}
+	else
+	{
+		UpdateAdjacencyList();
+	}
+}
+
+FGraphAdjacencyView UGraphElement::GetAdjacencyView()
+{
+	EnsureAdjacencyListUpToDate();
+
+	FGraphAdjacencyView View;
+	View.NodeTags = NodeTags;
+	View.Offsets = AdjacencyOffsets;
+	View.Neighbors = AdjacencyNeighbors;
+	View.Generation = AdjacencyGeneration;
+	return View;
+}
+
+const TArray<TArray<FGameplayTag>> &UGraphElement::GetAdjacencyList()
+{
+	const FGraphAdjacencyView View = GetAdjacencyView();
+	if (CachedAdjacencyListGeneration == View.Generation)
+		return CachedAdjacencyList;
+
+	// Expand into the node itself followed by its neighbors
+	CachedAdjacencyList.SetNum(View.Num());
+	for (int32 Node = 0; Node < View.Num(); ++Node)
+	{
+		const TConstArrayView<int32> Neighbors = View.GetNeighbors(Node);
+		TArray<FGameplayTag> &NodeConnections = CachedAdjacencyList[Node];
+		NodeConnections.Reset(1 + Neighbors.Num());
+		NodeConnections.Add(View.NodeTags[Node]);
+		for (const int32 Neighbor : Neighbors)
+		{
+			NodeConnections.Add(View.NodeTags[Neighbor]);
+		}
+	}
+	CachedAdjacencyListGeneration = View.Generation;
 	return CachedAdjacencyList;
 }
 
 void UGraphElement::UpdateAdjacencyList()
 {
 	UE_LOG(LogTemp, Log, TEXT("UGraphElement::UpdateAdjacencyList: Calculating adjacency list for graph %s"), *GetName());
-	CalculateAdjacencyList();
-	FormatDebugAdjacencyList();
+	if (CalculateAdjacencyList())
+	{
+		++AdjacencyGeneration;
+		FormatDebugAdjacencyList();
+	}
+	bAdjacencyListDirty = false;
+	OnAdjacencyListChanged.Broadcast(this);
+}
+
+void UGraphElement::MarkAdjacencyListDirty()
+{
+	// Listeners were told when it became dirty, they will read it again anyway
+	if (bAdjacencyListDirty)
+		return;
+
+	bAdjacencyListDirty = true;
+	OnAdjacencyListChanged.Broadcast(this);
 }
 
-void UGraphElement::CalculateAdjacencyList()
+bool UGraphElement::CalculateAdjacencyList()
 {
-	TMap<FGameplayTag, TSet<FGameplayTag>> AdjacencyMap;
+	// Intern every tag that takes part in a valid edge into a graph-local integer ID
+	TMap<FGameplayTag, int32> TagToId;
+	TArray<FGameplayTag> Tags;
+	TArray<TPair<int32, int32>> EdgeIds;
+	EdgeIds.Reserve(Edges.Num());
 
-	// // Add self to the map to ensure it appears even if it has no edges
-	// if (Tag.IsValid())
-	// {
-	// 	AdjacencyMap.FindOrAdd(Tag);
-	// }
+	auto Intern = [&TagToId, &Tags](const FGameplayTag &InTag)
+	{
+		if (const int32 *Id = TagToId.Find(InTag))
+			return *Id;
+		Tags.Add(InTag);
+		return TagToId.Add(InTag, Tags.Num() - 1);
+	};
 
 	for (const FGraphEdge &Edge : Edges)
 	{
 		if (Edge.ElementA && Edge.ElementA->Tag.IsValid() && Edge.ElementB && Edge.ElementB->Tag.IsValid())
 		{
-			// Add connections in both directions
-			AdjacencyMap.FindOrAdd(Edge.ElementA->Tag).Add(Edge.ElementB->Tag);
-			AdjacencyMap.FindOrAdd(Edge.ElementB->Tag).Add(Edge.ElementA->Tag);
+			EdgeIds.Emplace(Intern(Edge.ElementA->Tag), Intern(Edge.ElementB->Tag));
 		}
 	}
 
-	// Convert the adjacency map to an array of arrays
-	CachedAdjacencyList.Empty();
-	TArray<FGameplayTag> MapKeys;
-	AdjacencyMap.GetKeys(MapKeys);
-	MapKeys.Sort([](const FGameplayTag &A, const FGameplayTag &B) { // Sort for consistent debug output
-		return A.ToString() < B.ToString();
+	// Renumber the IDs in lexical tag order. Name table indices differ between sessions, so ordering by them
+	// would reshuffle baked node IDs after a restart.
+	const int32 NumNodes = Tags.Num();
+	TArray<int32> SortedToInterned;
+	SortedToInterned.SetNumUninitialized(NumNodes);
+	for (int32 i = 0; i < NumNodes; ++i)
+	{
+		SortedToInterned[i] = i;
+	}
+	SortedToInterned.Sort([&Tags](const int32 A, const int32 B) {
+		return Tags[A].GetTagName().LexicalLess(Tags[B].GetTagName());
 	});
 
-	for (const FGameplayTag &Key : MapKeys)
+	TArray<int32> InternedToSorted;
+	InternedToSorted.SetNumUninitialized(NumNodes);
+	TArray<FGameplayTag> NewNodeTags;
+	NewNodeTags.SetNumUninitialized(NumNodes);
+	for (int32 i = 0; i < NumNodes; ++i)
+	{
+		InternedToSorted[SortedToInterned[i]] = i;
+		NewNodeTags[i] = Tags[SortedToInterned[i]];
+	}
+
+	// Count the connections in both directions, then scatter them into compressed rows
+	TArray<int32> NewOffsets;
+	NewOffsets.SetNumZeroed(NumNodes + 1);
+	for (const TPair<int32, int32> &Edge : EdgeIds)
+	{
+		++NewOffsets[InternedToSorted[Edge.Key] + 1];
+		++NewOffsets[InternedToSorted[Edge.Value] + 1];
+	}
+	for (int32 i = 0; i < NumNodes; ++i)
 	{
-		TArray<FGameplayTag> NodeConnections;
-		NodeConnections.Add(Key); // Add the node itself
-		TArray<FGameplayTag> Neighbors = AdjacencyMap[Key].Array();
-		Neighbors.Sort([](const FGameplayTag &A, const FGameplayTag &B) { // Sort neighbors for consistent debug output
-			return A.ToString() < B.ToString();
-		});
-		NodeConnections.Append(Neighbors); // Add all connected nodes
-		CachedAdjacencyList.Add(NodeConnections);
+		NewOffsets[i + 1] += NewOffsets[i];
 	}
+
+	TArray<int32> Cursors(NewOffsets.GetData(), NumNodes);
+	TArray<int32> NewNeighbors;
+	NewNeighbors.SetNumUninitialized(NewOffsets[NumNodes]);
+	for (const TPair<int32, int32> &Edge : EdgeIds)
+	{
+		const int32 A = InternedToSorted[Edge.Key];
+		const int32 B = InternedToSorted[Edge.Value];
+		NewNeighbors[Cursors[A]++] = B;
+		NewNeighbors[Cursors[B]++] = A;
+	}
+
+	// Sort every row and drop duplicate edges, compacting the rows in place
+	int32 Write = 0;
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		const int32 Begin = NewOffsets[Node];
+		const int32 End = NewOffsets[Node + 1];
+		NewOffsets[Node] = Write;
+
+		TArrayView<int32>(NewNeighbors.GetData() + Begin, End - Begin).Sort();
+		int32 Previous = INDEX_NONE;
+		for (int32 i = Begin; i < End; ++i)
+		{
+			const int32 Neighbor = NewNeighbors[i];
+			if (Neighbor != Previous)
+			{
+				NewNeighbors[Write++] = Neighbor;
+				Previous = Neighbor;
+			}
+		}
+	}
+	NewOffsets[NumNodes] = Write;
+	NewNeighbors.SetNum(Write, EAllowShrinking::No);
+
+	// An edit that leaves the topology as it was keeps the generation, so consumers can skip their work
+	if (NewNodeTags == NodeTags && NewOffsets == AdjacencyOffsets && NewNeighbors == AdjacencyNeighbors)
+		return false;
+
+	NodeTags = MoveTemp(NewNodeTags);
+	AdjacencyOffsets = MoveTemp(NewOffsets);
+	AdjacencyNeighbors = MoveTemp(NewNeighbors);
+	return true;
 }
 
 void UGraphElement::FormatDebugAdjacencyList()
 {
 	DebugAdjacencyList.Empty(); // Clear the debug string
 
-	for (const TArray<FGameplayTag> &NodeConnections : CachedAdjacencyList)
+	for (int32 Node = 0; Node < NodeTags.Num(); ++Node)
 	{
-		if (NodeConnections.Num() > 0)
-		{
-			const FGameplayTag &Key = NodeConnections[0];
-			// The first element is the node itself
-			DebugAdjacencyList += FString::Printf(TEXT("%s -> ["), *Key.ToString());
+		DebugAdjacencyList += FString::Printf(TEXT("%s -> ["), *NodeTags[Node].ToString());
 
-			// Start from index 1 to get neighbors
-			for (int32 i = 1; i < NodeConnections.Num(); ++i)
-			{
-				DebugAdjacencyList += NodeConnections[i].ToString();
-				if (i < NodeConnections.Num() - 1)
-				{
-					DebugAdjacencyList += TEXT(", ");
-				}
-			}
-			DebugAdjacencyList += TEXT("]");
-			if (&NodeConnections != &CachedAdjacencyList.Last())
+		for (int32 i = AdjacencyOffsets[Node]; i < AdjacencyOffsets[Node + 1]; ++i)
+		{
+			DebugAdjacencyList += NodeTags[AdjacencyNeighbors[i]].ToString();
+			if (i < AdjacencyOffsets[Node + 1] - 1)
 			{
-				DebugAdjacencyList += TEXT("\n\n");
+				DebugAdjacencyList += TEXT(", ");
 			}
 		}
+		DebugAdjacencyList += TEXT("]");
+		if (Node < NodeTags.Num() - 1)
+		{
+			DebugAdjacencyList += TEXT("\n\n");
+		}
 	}
 }
 
@@ -105,21 +228,76 @@ TArray<UGraphElement *> UGraphElement::GetReferencedElements() const
 	return ReferencedElements;
 }
 
+void UGraphElement::GetAssetRegistryTags(FAssetRegistryTagsContext Context) const
+{
+	Super::GetAssetRegistryTags(Context);
+
+	// Lets the subsystem index dependencies without loading the asset
+	TArray<FString> ReferencedPaths;
+	for (const UGraphElement *Element : GetReferencedElements())
+	{
+		ReferencedPaths.Add(FSoftObjectPath(Element).ToString());
+	}
+	Context.AddTag(FAssetRegistryTag(ReferencedElementsTag, FString::Join(ReferencedPaths, TEXT(",")),
+	                                 FAssetRegistryTag::TT_Hidden));
+}
+
+void UGraphElement::PreSave(FObjectPreSaveContext SaveContext)
+{
+	Super::PreSave(SaveContext);
+
+	// Bake the compiled adjacency into the asset so loading does not have to compute it
+	EnsureAdjacencyListUpToDate();
+	bHasBakedAdjacency = true;
+}
+
+void UGraphElement::PostLoad()
+{
+	Super::PostLoad();
+
+	if (bHasBakedAdjacency)
+	{
+		AdjacencyGeneration = 1;
+
+		// Cooked data can't go stale and is used as is. In the editor a referenced element may have changed
+		// since this asset was saved, so it is still checked on first use; an unchanged result keeps the
+		// generation.
+		if (FPlatformProperties::RequiresCookedData())
+		{
+			bAdjacencyListDirty = false;
+		}
+	}
+
+	if (UArtGraphSubsystem *Subsystem = GEngine ? GEngine->GetEngineSubsystem<UArtGraphSubsystem>() : nullptr)
+	{
+		Subsystem->RegisterGraph(this, false);
+	}
+}
+
+void UGraphElement::BeginDestroy()
+{
+	// Graphs load and unload on demand, don't leave dangling entries in the subsystem's maps
+	UArtGraphSubsystem *Subsystem = GEngine && !IsEngineExitRequested() ? GEngine->GetEngineSubsystem<UArtGraphSubsystem>() : nullptr;
+	if (Subsystem)
+	{
+		Subsystem->UnregisterElement(this);
+	}
+
+	Super::BeginDestroy();
+}
+
 void UGraphElement::PostEditChangeProperty(FPropertyChangedEvent &PropertyChangedEvent)
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 
-	// Update the cached adjacency list
-	UpdateAdjacencyList();
-
 	if (UArtGraphSubsystem *Subsystem = GEngine->GetEngineSubsystem<UArtGraphSubsystem>())
 	{
-		// Register this graph and all of its referenced graphs with the subsystem.
-		// Pass true to clear previous references since the graph's references might have changed.
-		Subsystem->RegisterGraph(this, true);
-
-		// Notify the subsystem that this element might have changed,
-		// affecting graphs that reference it.
-		Subsystem->NotifyElementChanged(this);
+		// Re-registering this graph and dirtying everything that references it, directly or indirectly,
+		// happens once per batch or frame however many properties were edited in between.
+		Subsystem->QueueElementChanged(this);
+	}
+	else
+	{
+		MarkAdjacencyListDirty();
 	}
 }
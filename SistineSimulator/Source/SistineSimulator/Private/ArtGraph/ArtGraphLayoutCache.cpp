@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ArtGraph/ArtGraphLayoutCache.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	TAutoConsoleVariable<int32> CVarArtGraphLayoutCacheMaxMB(
+		TEXT("ArtGraph.LayoutCacheMaxMB"), 64,
+		TEXT("Memory the settled graph layouts may take, in megabytes. Storing past it drops the least recently ")
+		TEXT("used layouts, the cache file only keeps what remains."));
+}
+
+void UArtGraphLayoutCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddWeakLambda(
+		this, [this](UWorld*, bool, bool) { SaveIfDirty(); });
+
+	ClearCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("ArtGraph.ClearLayoutCache"),
+		TEXT("Forget every settled graph layout, so all graphs solve from scratch on their next start."),
+		FConsoleCommandDelegate::CreateWeakLambda(this, [this]() { Clear(); }),
+		ECVF_Default);
+}
+
+void UArtGraphLayoutCache::Deinitialize()
+{
+	SaveIfDirty();
+
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	if (ClearCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(ClearCommand);
+		ClearCommand = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+bool UArtGraphLayoutCache::FindLayout(const uint64 Key, const int32 NumNodes, ForceDirected::FLayoutBuffers& OutPositions)
+{
+	EnsureLoaded();
+	return Cache.Find(Key, NumNodes, OutPositions);
+}
+
+void UArtGraphLayoutCache::StoreLayout(const uint64 Key, const ForceDirected::FLayoutBuffers& Positions)
+{
+	EnsureLoaded();
+	Cache.SetMaxBytes(GetMaxBytes());
+	Cache.Store(Key, Positions);
+	bDirty = true;
+}
+
+void UArtGraphLayoutCache::Clear()
+{
+	Cache.Reset();
+	bLoaded = true;
+	bDirty = false;
+	IFileManager::Get().Delete(*GetCacheFilePath(), false, false, true);
+	UE_LOG(LogTemp, Log, TEXT("UArtGraphLayoutCache::Clear: Cleared the layout cache."));
+}
+
+void UArtGraphLayoutCache::SaveIfDirty()
+{
+	if (!bDirty)
+		return;
+
+	std::vector<uint8_t> Bytes;
+	Cache.Save(Bytes);
+	const FString FilePath = GetCacheFilePath();
+	if (FFileHelper::SaveArrayToFile(TArrayView<const uint8>(Bytes.data(), Bytes.size()), *FilePath))
+	{
+		bDirty = false;
+		UE_LOG(LogTemp, Log, TEXT("UArtGraphLayoutCache::SaveIfDirty: Saved %d layouts (%llu bytes) to %s."),
+		       Cache.Num(), static_cast<uint64>(Bytes.size()), *FilePath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UArtGraphLayoutCache::SaveIfDirty: Could not write %s."), *FilePath);
+	}
+}
+
+FString UArtGraphLayoutCache::GetCacheFilePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("ArtGraph") / TEXT("LayoutCache.bin");
+}
+
+size_t UArtGraphLayoutCache::GetMaxBytes()
+{
+	return static_cast<size_t>(FMath::Max(CVarArtGraphLayoutCacheMaxMB.GetValueOnGameThread(), 0)) << 20;
+}
+
+void UArtGraphLayoutCache::EnsureLoaded()
+{
+	if (bLoaded)
+		return;
+	bLoaded = true;
+	Cache.SetMaxBytes(GetMaxBytes());
+
+	const FString FilePath = GetCacheFilePath();
+	TArray<uint8> FileBytes;
+	if (!FFileHelper::LoadFileToArray(FileBytes, *FilePath, FILEREAD_Silent))
+		return;
+
+	// A cache from another version or a broken write is simply started over
+	const std::vector<uint8_t> Bytes(FileBytes.GetData(), FileBytes.GetData() + FileBytes.Num());
+	if (Cache.Load(Bytes))
+	{
+		UE_LOG(LogTemp, Log, TEXT("UArtGraphLayoutCache::EnsureLoaded: Loaded %d layouts from %s."), Cache.Num(), *FilePath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UArtGraphLayoutCache::EnsureLoaded: Ignoring unreadable layout cache %s."), *FilePath);
+	}
+}
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ArtGraph/ArtGraphLayoutSubsystem.h"
+#include "ArtGraph/ArtGraphStats.h"
+#include "ArtGraph/GraphUntangling.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	TAutoConsoleVariable<float> CVarArtGraphLayoutBudgetMs(
+		TEXT("ArtGraph.LayoutBudgetMs"), 8.f,
+		TEXT("Time all graph layouts of a world may spend solving per frame together, in milliseconds. ")
+		TEXT("0 leaves only the per-layout budgets."));
+}
+
+DECLARE_CYCLE_STAT(TEXT("Layout Subsystem Tick"), STAT_ArtGraph_LayoutSubsystemTick, STATGROUP_ArtGraph);
+DECLARE_CYCLE_STAT(TEXT("Batched Solve"), STAT_ArtGraph_BatchedSolve, STATGROUP_ArtGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Layouts Stepped"), STAT_ArtGraph_LayoutsStepped, STATGROUP_ArtGraph);
+
+void UArtGraphLayoutSubsystem::Deinitialize()
+{
+	Layouts.Empty();
+	PendingSteps.Empty();
+
+	Super::Deinitialize();
+}
+
+void UArtGraphLayoutSubsystem::RegisterLayout(AGraphUntangling* Layout)
+{
+	if (IsValid(Layout))
+	{
+		Layouts.AddUnique(Layout);
+	}
+}
+
+void UArtGraphLayoutSubsystem::UnregisterLayout(AGraphUntangling* Layout)
+{
+	// Only cleared here, layouts may end play while Tick walks the list. The next Tick drops the entry.
+	const int32 Index = Layouts.IndexOfByKey(Layout);
+	if (Index != INDEX_NONE)
+	{
+		Layouts[Index].Reset();
+	}
+}
+
+TStatId UArtGraphLayoutSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UArtGraphLayoutSubsystem, STATGROUP_Tickables);
+}
+
+void UArtGraphLayoutSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_ArtGraph_LayoutSubsystemTick);
+
+	// Priorities are editable at runtime, re-sorting a handful of layouts is cheaper than tracking changes
+	Layouts.RemoveAll([](const TWeakObjectPtr<AGraphUntangling>& Layout) { return !Layout.IsValid(); });
+	Layouts.StableSort([](const TWeakObjectPtr<AGraphUntangling>& A, const TWeakObjectPtr<AGraphUntangling>& B)
+	{
+		return A->LayoutPriority > B->LayoutPriority;
+	});
+
+	// Game thread: topology changes and syncing with the actors, in priority order
+	PendingSteps.Reset();
+	for (int32 Index = 0; Index < Layouts.Num(); ++Index)
+	{
+		AGraphUntangling* Layout = Layouts[Index].Get();
+		if (!Layout || Layout->IsLayoutSleeping())
+			continue;
+
+		if (Layout->bSolveAsynchronously)
+		{
+			Layout->TickLayout(DeltaTime);
+			continue;
+		}
+
+		if (!Layout->PrepareLayoutTick())
+			continue;
+
+		const int32 NumDue = Layout->BeginLayoutStep(DeltaTime);
+		if (NumDue > 0)
+		{
+			PendingSteps.Add({Layout, Layout->LayoutPriority, NumDue, 0});
+		}
+	}
+	if (PendingSteps.IsEmpty())
+	{
+		ReportStepStats();
+		return;
+	}
+
+	// Every layout solves on its own task. A lone layout may spread its force passes over the workers instead.
+	const float BudgetMs = CVarArtGraphLayoutBudgetMs.GetValueOnGameThread();
+	const double Deadline = BudgetMs > 0.f
+		                        ? FPlatformTime::Seconds() + BudgetMs * 0.001
+		                        : TNumericLimits<double>::Max();
+	const bool bSingleLayout = PendingSteps.Num() == 1;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ArtGraph_BatchedSolve);
+
+		// One dispatch per priority, so lower priorities only get what the higher ones left of the shared budget.
+		// Tiers that find it used up run nothing and keep their iterations for the next frame.
+		for (int32 TierStart = 0; TierStart < PendingSteps.Num() && FPlatformTime::Seconds() < Deadline;)
+		{
+			int32 TierEnd = TierStart + 1;
+			while (TierEnd < PendingSteps.Num() && PendingSteps[TierEnd].Priority == PendingSteps[TierStart].Priority)
+			{
+				++TierEnd;
+			}
+
+			ParallelFor(TierEnd - TierStart, [this, TierStart, Deadline, bSingleLayout](const int32 Index)
+			{
+				FPendingLayoutStep& Step = PendingSteps[TierStart + Index];
+				Step.NumRun = Step.Layout->RunLayoutSteps(Step.NumDue, Deadline, bSingleLayout);
+			}, bSingleLayout ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+			TierStart = TierEnd;
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_ArtGraph_LayoutsStepped, PendingSteps.Num());
+
+	// Game thread again: every write-back in one pass
+	for (const FPendingLayoutStep& Step : PendingSteps)
+	{
+		// Convergence callbacks of an earlier layout may have destroyed this one
+		if (IsValid(Step.Layout))
+		{
+			Step.Layout->EndLayoutStep(Step.NumRun);
+		}
+	}
+	ReportStepStats();
+}
+
+void UArtGraphLayoutSubsystem::ReportStepStats()
+{
+	FGraphLayoutStepStats Stats;
+	for (const TWeakObjectPtr<AGraphUntangling>& Layout : Layouts)
+	{
+		if (Layout.IsValid())
+		{
+			Layout->ConsumeStepStats(Stats);
+		}
+	}
+	if (Stats.NumLayouts > 0)
+	{
+		AGraphUntangling::ReportStepStats(Stats);
+	}
+}
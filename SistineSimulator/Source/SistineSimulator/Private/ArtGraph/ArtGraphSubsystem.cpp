@@ -2,6 +2,28 @@
 #include "ArtGraph/ArtGraph.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Engine/AssetManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "UObject/UObjectIterator.h"
+
+namespace
+{
+	// Referenced element paths from a graph asset's registry tag, false if it was saved before the tag existed
+	bool ReadReferencedPathsTag(const FAssetData &Data, TSet<FSoftObjectPath> &OutReferencedPaths)
+	{
+		FString ReferencedElements;
+		if (!Data.GetTagValue(UGraphElement::ReferencedElementsTag, ReferencedElements))
+			return false;
+
+		TArray<FString> Paths;
+		ReferencedElements.ParseIntoArray(Paths, TEXT(","));
+		for (const FString &Path : Paths)
+		{
+			OutReferencedPaths.Add(FSoftObjectPath(Path));
+		}
+		return true;
+	}
+}
 
 void UArtGraphSubsystem::RegisterGraph(UGraphElement *Graph, bool bClearPreviousReferences)
 {
@@ -15,13 +37,29 @@ void UArtGraphSubsystem::RegisterGraph(UGraphElement *Graph, bool bClearPrevious
 	}
 
 	UE_LOG(LogEngine, Display, TEXT("Registering ArtGraph %s"), *Graph->GetName());
+	TSet<UGraphElement *> &ReferencedElements = GraphToReferencedElementsMap.FindOrAdd(Graph);
+	TSet<FSoftObjectPath> ReferencedPaths;
 	for (UGraphElement *Element : Graph->GetReferencedElements())
 	{
 		if (Element) // Ensure the element is valid
 		{
 			ElementToDependentGraphsMap.FindOrAdd(Element).Add(Graph);
+			ReferencedElements.Add(Element);
+			ReferencedPaths.Add(FSoftObjectPath(Element));
 		}
 	}
+
+	// Graphs without references don't need an entry
+	if (ReferencedElements.IsEmpty())
+	{
+		GraphToReferencedElementsMap.Remove(Graph);
+	}
+
+	// The loaded graph is more recent than whatever the asset registry knew about it
+	if (Graph->IsAsset())
+	{
+		SetReferencedPaths(FSoftObjectPath(Graph), MoveTemp(ReferencedPaths));
+	}
 }
 
 void UArtGraphSubsystem::UnregisterGraph(UGraphElement *Graph)
@@ -31,41 +69,463 @@ void UArtGraphSubsystem::UnregisterGraph(UGraphElement *Graph)
 
 	UE_LOG(LogEngine, Display, TEXT("Unregistering ArtGraph %s"), *Graph->GetName());
 
-	// Iterate through the entire map to find and remove the graph
-	for (auto It = ElementToDependentGraphsMap.CreateIterator(); It; ++It)
+	// Only visit the elements this graph was registered with
+	TSet<UGraphElement *> ReferencedElements;
+	if (!GraphToReferencedElementsMap.RemoveAndCopyValue(Graph, ReferencedElements))
+		return;
+
+	for (UGraphElement *Element : ReferencedElements)
+	{
+		TSet<UGraphElement *> *Graphs = ElementToDependentGraphsMap.Find(Element);
+		if (!Graphs)
+			continue;
+
+		Graphs->Remove(Graph);
+
+		// If the set becomes empty after removal, remove the element entry from the map
+		if (Graphs->Num() == 0)
+		{
+			ElementToDependentGraphsMap.Remove(Element);
+		}
+	}
+}
+
+void UArtGraphSubsystem::UnregisterElement(UGraphElement *Element)
+{
+	if (!Element)
+		return;
+
+	UnregisterGraph(Element);
+
+	// Graphs referencing it hold it alive, so normally none are left; when they are destroyed in the same
+	// purge they find the entry gone and skip it
+	ElementToDependentGraphsMap.Remove(Element);
+	PendingChangedElements.Remove(Element);
+}
+
+TArray<FSoftObjectPath> UArtGraphSubsystem::GetDependentGraphPaths(const FSoftObjectPath &ElementPath,
+                                                                   const bool bTransitive) const
+{
+	TArray<FSoftObjectPath> DependentPaths;
+	TSet<FSoftObjectPath> Visited;
+	TArray<FSoftObjectPath> Pending;
+	Visited.Add(ElementPath);
+	Pending.Add(ElementPath);
+
+	while (!Pending.IsEmpty())
+	{
+		const FSoftObjectPath Path = Pending.Pop(EAllowShrinking::No);
+		const TSet<FSoftObjectPath> *GraphPaths = ElementPathToDependentGraphPathsMap.Find(Path);
+		if (!GraphPaths)
+			continue;
+
+		for (const FSoftObjectPath &GraphPath : *GraphPaths)
+		{
+			bool bAlreadyVisited = false;
+			Visited.Add(GraphPath, &bAlreadyVisited);
+			if (bAlreadyVisited)
+				continue;
+
+			DependentPaths.Add(GraphPath);
+			if (bTransitive)
+			{
+				Pending.Add(GraphPath);
+			}
+		}
+	}
+	return DependentPaths;
+}
+
+TSharedPtr<FStreamableHandle> UArtGraphSubsystem::RequestGraphAsync(const FSoftObjectPath &GraphPath,
+                                                                    FStreamableDelegate OnLoaded)
+{
+	// Graphs register themselves in PostLoad, nothing else to do once they arrive
+	return UAssetManager::GetStreamableManager().RequestAsyncLoad(GraphPath, MoveTemp(OnLoaded));
+}
+
+void UArtGraphSubsystem::SetReferencedPaths(const FSoftObjectPath &GraphPath, TSet<FSoftObjectPath> &&ReferencedPaths)
+{
+	RemoveReferencedPaths(GraphPath);
+	if (ReferencedPaths.IsEmpty())
+		return;
+
+	for (const FSoftObjectPath &ElementPath : ReferencedPaths)
+	{
+		ElementPathToDependentGraphPathsMap.FindOrAdd(ElementPath).Add(GraphPath);
+	}
+	GraphPathToReferencedPathsMap.Add(GraphPath, MoveTemp(ReferencedPaths));
+}
+
+void UArtGraphSubsystem::RemoveReferencedPaths(const FSoftObjectPath &GraphPath)
+{
+	TSet<FSoftObjectPath> ReferencedPaths;
+	if (!GraphPathToReferencedPathsMap.RemoveAndCopyValue(GraphPath, ReferencedPaths))
+		return;
+
+	for (const FSoftObjectPath &ElementPath : ReferencedPaths)
 	{
-		UGraphElement *Element = It.Key();
-		TSet<UGraphElement *> &Graphs = It.Value();
+		TSet<FSoftObjectPath> *GraphPaths = ElementPathToDependentGraphPathsMap.Find(ElementPath);
+		if (GraphPaths && GraphPaths->Remove(GraphPath) > 0 && GraphPaths->IsEmpty())
+		{
+			ElementPathToDependentGraphPathsMap.Remove(ElementPath);
+		}
+	}
+}
+
+void UArtGraphSubsystem::IndexGraphAssets()
+{
+	IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	TArray<FAssetData> AssetData;
+	AssetRegistry.GetAssetsByClass(UGraphElement::StaticClass()->GetClassPathName(), AssetData);
 
-		if (Graphs.Contains(Graph))
+	int32 NumUntagged = 0;
+	for (const FAssetData &Data : AssetData)
+	{
+		TSet<FSoftObjectPath> ReferencedPaths;
+		if (!ReadReferencedPathsTag(Data, ReferencedPaths))
 		{
-			Graphs.Remove(Graph);
+			// Saved before the tag existed, its dependencies become known when it is loaded
+			++NumUntagged;
+			continue;
+		}
 
-			// If the set becomes empty after removal, remove the element entry from the map
-			if (Graphs.Num() == 0)
+		// Loaded graphs registered already and are more recent than their tags
+		if (!Data.IsAssetLoaded())
+		{
+			SetReferencedPaths(Data.GetSoftObjectPath(), MoveTemp(ReferencedPaths));
+		}
+	}
+
+	UE_LOG(LogEngine, Display, TEXT("Indexed %d UGraphElement assets without loading them (%d without tags)."),
+	       AssetData.Num(), NumUntagged);
+}
+
+void UArtGraphSubsystem::HandleAssetRemoved(const FAssetData &AssetData)
+{
+	RemoveReferencedPaths(AssetData.GetSoftObjectPath());
+}
+
+void UArtGraphSubsystem::HandleAssetRenamed(const FAssetData &AssetData, const FString &OldObjectPath)
+{
+	const FSoftObjectPath OldPath(OldObjectPath);
+	const FSoftObjectPath NewPath = AssetData.GetSoftObjectPath();
+
+	// Graphs referencing the renamed asset now reference it under its new path
+	TSet<FSoftObjectPath> DependentGraphPaths;
+	if (ElementPathToDependentGraphPathsMap.RemoveAndCopyValue(OldPath, DependentGraphPaths))
+	{
+		for (const FSoftObjectPath &GraphPath : DependentGraphPaths)
+		{
+			if (TSet<FSoftObjectPath> *ReferencedPaths = GraphPathToReferencedPathsMap.Find(GraphPath))
 			{
-				It.RemoveCurrent();
+				ReferencedPaths->Remove(OldPath);
+				ReferencedPaths->Add(NewPath);
 			}
 		}
+		ElementPathToDependentGraphPathsMap.FindOrAdd(NewPath).Append(DependentGraphPaths);
+	}
+
+	// Its own references move to the new path. A loaded graph is more recent than its tags.
+	RemoveReferencedPaths(OldPath);
+	if (UGraphElement *Graph = Cast<UGraphElement>(AssetData.FastGetAsset(false)))
+	{
+		RegisterGraph(Graph, true);
+	}
+	else
+	{
+		TSet<FSoftObjectPath> ReferencedPaths;
+		if (ReadReferencedPathsTag(AssetData, ReferencedPaths))
+		{
+			SetReferencedPaths(NewPath, MoveTemp(ReferencedPaths));
+		}
 	}
 }
 
+bool UArtGraphSubsystem::CheckConsistency(TArray<FString> *OutErrors) const
+{
+	int32 NumErrors = 0;
+	auto ReportError = [&NumErrors, OutErrors](FString &&Error)
+	{
+		UE_LOG(LogEngine, Error, TEXT("UArtGraphSubsystem::CheckConsistency: %s"), *Error);
+		if (OutErrors)
+		{
+			OutErrors->Add(MoveTemp(Error));
+		}
+		++NumErrors;
+	};
+
+	for (const TPair<UGraphElement *, TSet<UGraphElement *>> &Entry : ElementToDependentGraphsMap)
+	{
+		if (Entry.Value.IsEmpty())
+		{
+			ReportError(FString::Printf(TEXT("Element %s has an empty set of dependent graphs."), *GetNameSafe(Entry.Key)));
+		}
+		for (UGraphElement *Graph : Entry.Value)
+		{
+			const TSet<UGraphElement *> *ReferencedElements = GraphToReferencedElementsMap.Find(Graph);
+			if (!ReferencedElements || !ReferencedElements->Contains(Entry.Key))
+			{
+				ReportError(FString::Printf(TEXT("Graph %s depends on element %s but has no reverse entry for it."),
+				                            *GetNameSafe(Graph), *GetNameSafe(Entry.Key)));
+			}
+		}
+	}
+
+	for (const TPair<UGraphElement *, TSet<UGraphElement *>> &Entry : GraphToReferencedElementsMap)
+	{
+		if (Entry.Value.IsEmpty())
+		{
+			ReportError(FString::Printf(TEXT("Graph %s has an empty set of referenced elements."), *GetNameSafe(Entry.Key)));
+		}
+		for (UGraphElement *Element : Entry.Value)
+		{
+			const TSet<UGraphElement *> *Graphs = ElementToDependentGraphsMap.Find(Element);
+			if (!Graphs || !Graphs->Contains(Entry.Key))
+			{
+				ReportError(FString::Printf(TEXT("Graph %s references element %s but is missing from its dependents."),
+				                            *GetNameSafe(Entry.Key), *GetNameSafe(Element)));
+			}
+		}
+	}
+
+	UE_LOG(LogEngine, Display,
+	       TEXT("UArtGraphSubsystem::CheckConsistency: %d elements, %d graphs, %d error(s)."),
+	       ElementToDependentGraphsMap.Num(), GraphToReferencedElementsMap.Num(), NumErrors);
+	return NumErrors == 0;
+}
+
 void UArtGraphSubsystem::NotifyElementChanged(UGraphElement *ChangedElement)
 {
 	if (!ChangedElement)
 		return;
 
-	if (TSet<UGraphElement *> *Graphs = ElementToDependentGraphsMap.Find(ChangedElement))
+	TSet<UGraphElement *> DirtiedGraphs;
+	MarkDependentsDirty(MakeArrayView(&ChangedElement, 1), DirtiedGraphs);
+}
+
+void UArtGraphSubsystem::MarkDependentsDirty(TConstArrayView<UGraphElement *> ChangedElements,
+                                             TSet<UGraphElement *> &OutDirtiedGraphs)
+{
+	// Walk the transitive dependents of all changed elements together, visiting every graph once however
+	// many paths lead to it. Cycles are harmless here and reported by RebuildAdjacencyList.
+	// The changed elements themselves were dirtied by whoever changed them.
+	TSet<UGraphElement *> Visited(ChangedElements);
+	TArray<UGraphElement *> Pending(ChangedElements);
+
+	while (!Pending.IsEmpty())
 	{
+		UGraphElement *Element = Pending.Pop(EAllowShrinking::No);
+		const TSet<UGraphElement *> *Graphs = ElementToDependentGraphsMap.Find(Element);
+		if (!Graphs)
+			continue;
+
 		for (UGraphElement *Graph : *Graphs)
 		{
-			if (Graph)
+			if (!Graph)
+				continue;
+
+			bool bAlreadyVisited = false;
+			Visited.Add(Graph, &bAlreadyVisited);
+			if (bAlreadyVisited)
+				continue;
+
+			Graph->MarkAdjacencyListDirty();
+			OutDirtiedGraphs.Add(Graph);
+			Pending.Add(Graph);
+		}
+	}
+}
+
+void UArtGraphSubsystem::QueueElementChanged(UGraphElement *ChangedElement)
+{
+	if (!ChangedElement)
+		return;
+
+	// Readers in the meantime get a fresh list for the element itself; dependents follow on the flush
+	ChangedElement->MarkAdjacencyListDirty();
+	PendingChangedElements.Add(ChangedElement);
+}
+
+void UArtGraphSubsystem::BeginChangeBatch()
+{
+	++BatchDepth;
+}
+
+void UArtGraphSubsystem::EndChangeBatch()
+{
+	if (BatchDepth == 0)
+	{
+		UE_LOG(LogEngine, Warning, TEXT("UArtGraphSubsystem::EndChangeBatch: No change batch is open."));
+		return;
+	}
+
+	if (--BatchDepth == 0)
+	{
+		FlushPendingChanges();
+	}
+}
+
+FArtGraphFlushStats UArtGraphSubsystem::FlushPendingChanges()
+{
+	FArtGraphFlushStats Stats;
+	if (PendingChangedElements.IsEmpty())
+		return Stats;
+
+	// Take the queue first, listeners may edit elements again and those land in the next flush
+	TArray<UGraphElement *> ChangedElements;
+	ChangedElements.Reserve(PendingChangedElements.Num());
+	for (const TWeakObjectPtr<UGraphElement> &Element : PendingChangedElements)
+	{
+		if (UGraphElement *ChangedElement = Element.Get())
+		{
+			ChangedElements.Add(ChangedElement);
+		}
+	}
+	PendingChangedElements.Reset();
+
+	// References might have changed, re-register before walking the dependents
+	for (UGraphElement *Element : ChangedElements)
+	{
+		RegisterGraph(Element, true);
+	}
+
+	TSet<UGraphElement *> DirtiedGraphs;
+	MarkDependentsDirty(ChangedElements, DirtiedGraphs);
+
+	// Dependents that aren't in memory can't be dirtied, the asset registry index still knows about them
+	TSet<FSoftObjectPath> UnloadedDependentPaths;
+	for (UGraphElement *Element : ChangedElements)
+	{
+		if (!Element->IsAsset())
+			continue;
+
+		for (const FSoftObjectPath &GraphPath : GetDependentGraphPaths(FSoftObjectPath(Element), true))
+		{
+			if (!GraphPath.ResolveObject())
 			{
-				// UE_LOG(LogEngine, Display, TEXT("ArtGraph %s updated due to change in element %s"), *Graph->GetName(), *ChangedElement->GetName());
-				Graph->UpdateAdjacencyList();
+				UnloadedDependentPaths.Add(GraphPath);
 			}
 		}
 	}
+
+	// Nothing is rebuilt here. Listeners were told when the graphs became dirty, and each graph rebuilds once
+	// when somebody next reads it, so graphs nobody looks at cost nothing.
+	Stats.NumChangedElements = ChangedElements.Num();
+	Stats.NumDirtiedGraphs = DirtiedGraphs.Num();
+	Stats.NumRebuilds = NumAdjacencyListRebuilds - RebuildsAtLastFlush;
+	RebuildsAtLastFlush = NumAdjacencyListRebuilds;
+	Stats.NumUnloadedDependentGraphs = UnloadedDependentPaths.Num();
+	LastFlushStats = Stats;
+
+	UE_LOG(LogEngine, Log,
+	       TEXT("UArtGraphSubsystem::FlushPendingChanges: %d changed elements, %d graphs dirtied, %d rebuilt since the last flush, %d unloaded dependents."),
+	       Stats.NumChangedElements, Stats.NumDirtiedGraphs, Stats.NumRebuilds, Stats.NumUnloadedDependentGraphs);
+	for (const FSoftObjectPath &GraphPath : UnloadedDependentPaths)
+	{
+		UE_LOG(LogEngine, Verbose,
+		       TEXT("UArtGraphSubsystem::FlushPendingChanges: %s is not loaded, its adjacency is rechecked when it is."),
+		       *GraphPath.ToString());
+	}
+	return Stats;
+}
+
+void UArtGraphSubsystem::HandleEndFrame()
+{
+	// Edits made outside of any batch are coalesced per frame
+	if (BatchDepth == 0)
+	{
+		FlushPendingChanges();
+	}
+}
+
+void UArtGraphSubsystem::RebuildAdjacencyList(UGraphElement *Graph)
+{
+	if (!Graph || !Graph->IsAdjacencyListDirty())
+		return;
+
+	// Iterative post-order depth-first search over the references: a graph is rebuilt once all the dirty
+	// graphs below it are. Graphs still on the stack mark a cycle.
+	struct FFrame
+	{
+		UGraphElement *Graph;
+		TArray<UGraphElement *> Dependencies;
+		int32 Next = 0;
+	};
+
+	auto MakeFrame = [this](UGraphElement *InGraph)
+	{
+		FFrame Frame{InGraph};
+		if (const TSet<UGraphElement *> *ReferencedElements = GraphToReferencedElementsMap.Find(InGraph))
+		{
+			Frame.Dependencies = ReferencedElements->Array();
+		}
+		return Frame;
+	};
+
+	TArray<FFrame> Stack;
+	TSet<UGraphElement *> OnStack;
+	Stack.Add(MakeFrame(Graph));
+	OnStack.Add(Graph);
+
+	while (!Stack.IsEmpty())
+	{
+		FFrame &Frame = Stack.Last();
+		if (Frame.Next < Frame.Dependencies.Num())
+		{
+			UGraphElement *Dependency = Frame.Dependencies[Frame.Next++];
+			if (!Dependency || Dependency == Frame.Graph || !Dependency->IsAdjacencyListDirty())
+				continue;
+
+			if (OnStack.Contains(Dependency))
+			{
+				UE_LOG(LogEngine, Warning,
+				       TEXT("UArtGraphSubsystem::RebuildAdjacencyList: Reference cycle between %s and %s, rebuilding without waiting for it."),
+				       *Frame.Graph->GetName(), *Dependency->GetName());
+				continue;
+			}
+
+			OnStack.Add(Dependency);
+			Stack.Add(MakeFrame(Dependency));
+			continue;
+		}
+
+		// Everything this graph depends on is up to date
+		UGraphElement *Finished = Frame.Graph;
+		Stack.Pop(EAllowShrinking::No);
+		OnStack.Remove(Finished);
+		if (Finished->IsAdjacencyListDirty())
+		{
+			Finished->UpdateAdjacencyList();
+			++NumAdjacencyListRebuilds;
+		}
+	}
+}
+
+void UArtGraphSubsystem::Deinitialize()
+{
+	if (CheckConsistencyCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(CheckConsistencyCommand);
+		CheckConsistencyCommand = nullptr;
+	}
+
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	FlushPendingChanges();
+	BatchDepth = 0;
+
+	if (IAssetRegistry *AssetRegistry = IAssetRegistry::Get())
+	{
+		AssetRegistry->OnFilesLoaded().RemoveAll(this);
+		AssetRegistry->OnAssetRemoved().RemoveAll(this);
+		AssetRegistry->OnAssetRenamed().RemoveAll(this);
+	}
+
+	ElementToDependentGraphsMap.Empty();
+	GraphToReferencedElementsMap.Empty();
+	ElementPathToDependentGraphPathsMap.Empty();
+	GraphPathToReferencedPathsMap.Empty();
+
+	Super::Deinitialize();
 }
 
 void UArtGraphSubsystem::Initialize(FSubsystemCollectionBase &Collection)
@@ -75,35 +535,56 @@ void UArtGraphSubsystem::Initialize(FSubsystemCollectionBase &Collection)
 	// Log a message to confirm the subsystem is initialized
 	UE_LOG(LogEngine, Display, TEXT("ArtGraphSubsystem initializing..."));
 
-	// Scan for all UGraphElement assets and register them
-	FAssetRegistryModule &AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
-	TArray<FAssetData> AssetData;
-	// Use the correct class name here - UGraphElement
-	AssetRegistryModule.Get().GetAssetsByClass(UGraphElement::StaticClass()->GetClassPathName(), AssetData);
+	CheckConsistencyCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("ArtGraph.CheckConsistency"),
+		TEXT("Verify that the ArtGraph subsystem's element and graph dependency maps mirror each other."),
+		FConsoleCommandDelegate::CreateWeakLambda(this, [this]() { CheckConsistency(); }),
+		ECVF_Default);
 
-	UE_LOG(LogEngine, Display, TEXT("Found %d UGraphElement assets."), AssetData.Num());
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UArtGraphSubsystem::HandleEndFrame);
 
-	for (const FAssetData &Data : AssetData)
+	// Graphs loaded before the subsystem existed; everything loaded later registers itself in PostLoad
+	for (TObjectIterator<UGraphElement> It; It; ++It)
 	{
-		UGraphElement *GraphElement = Cast<UGraphElement>(Data.GetAsset());
-		if (GraphElement)
-		{
-			// Ensure the asset is fully loaded before accessing properties like ReferencedElements
-			GraphElement->ConditionalPostLoad();
-			GraphElement->UpdateAdjacencyList(); // Update the adjacency list for the graph element
-			// Register without clearing previous references during initialization,
-			// as the map is empty initially.
-			RegisterGraph(GraphElement, false);
-		}
-		else
+		if (!It->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
 		{
-			UE_LOG(LogEngine, Warning, TEXT("Failed to load or cast asset: %s"), *Data.GetObjectPathString());
+			RegisterGraph(*It, false);
 		}
 	}
 
+	// Index the dependencies of every graph asset from its registry tags, without loading any of them
+	IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		AssetRegistry.OnFilesLoaded().AddUObject(this, &UArtGraphSubsystem::IndexGraphAssets);
+	}
+	else
+	{
+		IndexGraphAssets();
+	}
+	AssetRegistry.OnAssetRemoved().AddUObject(this, &UArtGraphSubsystem::HandleAssetRemoved);
+	AssetRegistry.OnAssetRenamed().AddUObject(this, &UArtGraphSubsystem::HandleAssetRenamed);
+
 	UE_LOG(LogEngine, Display, TEXT("ArtGraphSubsystem initialized successfully."));
 	if (GEngine)
 	{
 		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, TEXT("ArtGraphSubsystem initialized successfully."));
 	}
 }
+
+FScopedArtGraphChangeBatch::FScopedArtGraphChangeBatch()
+	: Subsystem(GEngine ? GEngine->GetEngineSubsystem<UArtGraphSubsystem>() : nullptr)
+{
+	if (UArtGraphSubsystem *ArtGraphSubsystem = Subsystem.Get())
+	{
+		ArtGraphSubsystem->BeginChangeBatch();
+	}
+}
+
+FScopedArtGraphChangeBatch::~FScopedArtGraphChangeBatch()
+{
+	if (UArtGraphSubsystem *ArtGraphSubsystem = Subsystem.Get())
+	{
+		ArtGraphSubsystem->EndChangeBatch();
+	}
+}
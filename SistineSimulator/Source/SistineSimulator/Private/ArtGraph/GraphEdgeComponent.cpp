@@ -0,0 +1,494 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ArtGraph/GraphEdgeComponent.h"
+#include "ArtGraph/ArtGraphStats.h"
+#include "Algo/Unique.h"
+#include "DynamicMeshBuilder.h"
+#include "Engine/Engine.h"
+#include "LocalVertexFactory.h"
+#include "Materials/Material.h"
+#include "MaterialDomain.h"
+#include "PrimitiveSceneProxy.h"
+#include "PrimitiveUniformShaderParameters.h"
+#include "RenderingThread.h"
+#include "SceneManagement.h"
+#include "StaticMeshResources.h"
+
+DECLARE_CYCLE_STAT(TEXT("Draw Edges"), STAT_ArtGraph_Draw, STATGROUP_ArtGraph);
+DECLARE_CYCLE_STAT(TEXT("Update Edge Positions"), STAT_ArtGraph_EdgeUpdate, STATGROUP_ArtGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Edge Nodes Updated"), STAT_ArtGraph_EdgeNodesUpdated, STATGROUP_ArtGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Edge Vertex Ranges Uploaded"), STAT_ArtGraph_EdgeRangesUploaded, STATGROUP_ArtGraph);
+
+namespace
+{
+	// Every edge is two quads crossed along it, so it has some width from every side without per-view work
+	constexpr int32 GEdge_Vertices = 8;
+	constexpr int32 GEdge_Indices = 12;
+
+	// Dirty edges closer than this are uploaded as one range, rewriting the clean ones in between is cheaper
+	// than another lock
+	constexpr int32 GEdge_Range_Merge_Gap = 32;
+}
+
+/**
+ * Render thread copy of the edges and their endpoints. Their geometry lives in persistent vertex buffers drawn as
+ * a single mesh batch; updates only rewrite the vertices of the edges they touch.
+ */
+class FGraphEdgeSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+	using FEdgeInstance = UGraphEdgeComponent::FEdgeInstance;
+
+	// Changes gathered on the game thread during one frame
+	struct FUpdate
+	{
+		TArray<int32> Nodes;
+		TArray<FVector3f> Positions;
+		TArray<int32> Edges;
+		TArray<FEdgeInstance> EdgeInstances;
+	};
+
+	explicit FGraphEdgeSceneProxy(const UGraphEdgeComponent* Component)
+		: FPrimitiveSceneProxy(Component)
+		  , VertexFactory(GetScene().GetFeatureLevel(), "FGraphEdgeSceneProxy")
+		  , Material(Component->GetEdgeMaterial())
+		  , MaterialRelevance(Material->GetRelevance_Concurrent(GetScene().GetFeatureLevel()))
+		  , NodePositions(Component->NodePositions)
+		  , Edges(Component->Edges)
+	{
+		bWillEverBeLit = false;
+
+		// Edges of every node, so a moved node knows which vertices to rewrite
+		NodeEdgeOffsets.SetNumZeroed(NodePositions.Num() + 1);
+		for (const FEdgeInstance& Edge : Edges)
+		{
+			if (Edge.A != INDEX_NONE)
+			{
+				++NodeEdgeOffsets[Edge.A + 1];
+				++NodeEdgeOffsets[Edge.B + 1];
+			}
+		}
+		for (int32 v = 0; v < NodePositions.Num(); ++v)
+		{
+			NodeEdgeOffsets[v + 1] += NodeEdgeOffsets[v];
+		}
+		NodeEdges.SetNumUninitialized(NodeEdgeOffsets.Last());
+		TArray<int32> Cursor(NodeEdgeOffsets.GetData(), NodePositions.Num());
+		for (int32 e = 0; e < Edges.Num(); ++e)
+		{
+			if (Edges[e].A != INDEX_NONE)
+			{
+				NodeEdges[Cursor[Edges[e].A]++] = e;
+				NodeEdges[Cursor[Edges[e].B]++] = e;
+			}
+		}
+
+		// The vertex buffers keep a CPU copy, dirty ranges are rewritten there and uploaded from it
+		const int32 NumVertices = Edges.Num() * GEdge_Vertices;
+		VertexBuffers.PositionVertexBuffer.Init(NumVertices);
+		VertexBuffers.StaticMeshVertexBuffer.Init(NumVertices, 1);
+		VertexBuffers.ColorVertexBuffer.Init(NumVertices);
+		for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+		{
+			VertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(Vertex, FVector3f::XAxisVector,
+			                                                       FVector3f::YAxisVector, FVector3f::ZAxisVector);
+			VertexBuffers.StaticMeshVertexBuffer.SetVertexUV(Vertex, 0, FVector2f::ZeroVector);
+		}
+		for (int32 e = 0; e < Edges.Num(); ++e)
+		{
+			WriteEdgeVertices(e);
+		}
+
+		// Topology never changes for the lifetime of the proxy, a new graph gets a new proxy
+		IndexBuffer.Indices.SetNumUninitialized(Edges.Num() * GEdge_Indices);
+		for (int32 e = 0; e < Edges.Num(); ++e)
+		{
+			const uint32 Base = e * GEdge_Vertices;
+			uint32* Indices = &IndexBuffer.Indices[e * GEdge_Indices];
+			for (uint32 Quad = 0; Quad < 2; ++Quad)
+			{
+				const uint32 First = Base + Quad * 4;
+				*Indices++ = First;
+				*Indices++ = First + 1;
+				*Indices++ = First + 2;
+				*Indices++ = First + 2;
+				*Indices++ = First + 1;
+				*Indices++ = First + 3;
+			}
+		}
+	}
+
+	virtual ~FGraphEdgeSceneProxy() override
+	{
+		VertexBuffers.PositionVertexBuffer.ReleaseResource();
+		VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+		VertexBuffers.ColorVertexBuffer.ReleaseResource();
+		IndexBuffer.ReleaseResource();
+		VertexFactory.ReleaseResource();
+	}
+
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+	virtual void CreateRenderThreadResources(FRHICommandListBase& RHICmdList) override
+	{
+		VertexBuffers.PositionVertexBuffer.InitResource(RHICmdList);
+		VertexBuffers.StaticMeshVertexBuffer.InitResource(RHICmdList);
+		VertexBuffers.ColorVertexBuffer.InitResource(RHICmdList);
+		IndexBuffer.InitResource(RHICmdList);
+
+		FLocalVertexFactory::FDataType Data;
+		VertexBuffers.PositionVertexBuffer.BindPositionVertexBuffer(&VertexFactory, Data);
+		VertexBuffers.StaticMeshVertexBuffer.BindTangentVertexBuffer(&VertexFactory, Data);
+		VertexBuffers.StaticMeshVertexBuffer.BindPackedTexCoordVertexBuffer(&VertexFactory, Data);
+		VertexBuffers.ColorVertexBuffer.BindColorVertexBuffer(&VertexFactory, Data);
+		VertexFactory.SetData(RHICmdList, Data);
+		VertexFactory.InitResource(RHICmdList);
+	}
+
+	void ApplyUpdate_RenderThread(FRHICommandListBase& RHICmdList, const FUpdate& Update)
+	{
+		check(IsInRenderingThread());
+
+		// Restyled edges need new colors, and like the edges of moved nodes new positions
+		TArray<int32> MovedEdges;
+		TArray<int32> RestyledEdges;
+		for (int32 i = 0; i < Update.Nodes.Num(); ++i)
+		{
+			const int32 Node = Update.Nodes[i];
+			if (!NodePositions.IsValidIndex(Node))
+				continue;
+
+			NodePositions[Node] = Update.Positions[i];
+			for (int32 k = NodeEdgeOffsets[Node]; k < NodeEdgeOffsets[Node + 1]; ++k)
+			{
+				MovedEdges.Add(NodeEdges[k]);
+			}
+		}
+		for (int32 i = 0; i < Update.Edges.Num(); ++i)
+		{
+			if (Edges.IsValidIndex(Update.Edges[i]))
+			{
+				Edges[Update.Edges[i]] = Update.EdgeInstances[i];
+				MovedEdges.Add(Update.Edges[i]);
+				RestyledEdges.Add(Update.Edges[i]);
+			}
+		}
+
+		// An edge between two moved nodes is listed twice
+		MovedEdges.Sort();
+		MovedEdges.SetNum(Algo::Unique(MovedEdges));
+		RestyledEdges.Sort();
+		RestyledEdges.SetNum(Algo::Unique(RestyledEdges));
+		for (const int32 Edge : MovedEdges)
+		{
+			WriteEdgeVertices(Edge);
+		}
+
+		FPositionVertexBuffer& Positions = VertexBuffers.PositionVertexBuffer;
+		FColorVertexBuffer& Colors = VertexBuffers.ColorVertexBuffer;
+		UploadEdgeRanges(RHICmdList, Positions.VertexBufferRHI, Positions.GetVertexData(), Positions.GetStride(),
+		                 MovedEdges);
+		UploadEdgeRanges(RHICmdList, Colors.VertexBufferRHI, Colors.GetVertexData(), Colors.GetStride(),
+		                 RestyledEdges);
+	}
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily,
+	                                    const uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ArtGraph_Draw);
+
+		// Vertices are in world space, the component's transform doesn't apply
+		FDynamicPrimitiveUniformBuffer& PrimitiveUniformBuffer =
+			Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
+		PrimitiveUniformBuffer.Set(Collector.GetRHICommandList(), FMatrix::Identity, FMatrix::Identity, GetBounds(),
+		                           GetBounds(), GetBounds(), false, false, false);
+
+		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ++ViewIndex)
+		{
+			if (!(VisibilityMap & (1 << ViewIndex)))
+				continue;
+
+			// The whole graph is one batch over the persistent buffers, nothing is rebuilt here
+			FMeshBatch& Mesh = Collector.AllocateMesh();
+			Mesh.VertexFactory = &VertexFactory;
+			Mesh.MaterialRenderProxy = Material->GetRenderProxy();
+			Mesh.Type = PT_TriangleList;
+			Mesh.DepthPriorityGroup = SDPG_World;
+			Mesh.bCanApplyViewModeOverrides = false;
+			Mesh.bDisableBackfaceCulling = true;
+			Mesh.CastShadow = false;
+
+			FMeshBatchElement& Element = Mesh.Elements[0];
+			Element.IndexBuffer = &IndexBuffer;
+			Element.FirstIndex = 0;
+			Element.NumPrimitives = Edges.Num() * GEdge_Indices / 3;
+			Element.MinVertexIndex = 0;
+			Element.MaxVertexIndex = Edges.Num() * GEdge_Vertices - 1;
+			Element.PrimitiveUniformBufferResource = &PrimitiveUniformBuffer.UniformBuffer;
+
+			Collector.AddMesh(ViewIndex, Mesh);
+		}
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance Result;
+		Result.bDrawRelevance = IsShown(View);
+		Result.bDynamicRelevance = true;
+		Result.bShadowRelevance = false;
+		MaterialRelevance.SetPrimitiveViewRelevance(Result);
+		return Result;
+	}
+
+	virtual uint32 GetMemoryFootprint() const override
+	{
+		return sizeof(*this) + GetAllocatedSize();
+	}
+
+	uint32 GetAllocatedSize() const
+	{
+		return FPrimitiveSceneProxy::GetAllocatedSize() + NodePositions.GetAllocatedSize() + Edges.GetAllocatedSize()
+			+ NodeEdgeOffsets.GetAllocatedSize() + NodeEdges.GetAllocatedSize()
+			+ VertexBuffers.PositionVertexBuffer.GetAllocatedSize()
+			+ VertexBuffers.StaticMeshVertexBuffer.GetResourceSize()
+			+ VertexBuffers.ColorVertexBuffer.GetAllocatedSize() + IndexBuffer.Indices.GetAllocatedSize();
+	}
+
+private:
+	FStaticMeshVertexBuffers VertexBuffers;
+	FDynamicMeshIndexBuffer32 IndexBuffer;
+	FLocalVertexFactory VertexFactory;
+
+	UMaterialInterface* Material;
+	FMaterialRelevance MaterialRelevance;
+
+	TArray<FVector3f> NodePositions;
+	TArray<FEdgeInstance> Edges;
+
+	// Edges touching node v are NodeEdges[NodeEdgeOffsets[v] .. NodeEdgeOffsets[v + 1])
+	TArray<int32> NodeEdgeOffsets;
+	TArray<int32> NodeEdges;
+
+	// Rebuild the CPU copy of one edge's vertices. Placeholders collapse to a point and draw nothing.
+	void WriteEdgeVertices(const int32 EdgeIndex)
+	{
+		const FEdgeInstance& Edge = Edges[EdgeIndex];
+		const int32 Base = EdgeIndex * GEdge_Vertices;
+		if (Edge.A == INDEX_NONE)
+		{
+			for (int32 i = 0; i < GEdge_Vertices; ++i)
+			{
+				VertexBuffers.PositionVertexBuffer.VertexPosition(Base + i) = FVector3f::ZeroVector;
+				VertexBuffers.ColorVertexBuffer.VertexColor(Base + i) = FColor::Transparent;
+			}
+			return;
+		}
+
+		const FVector3f A = NodePositions[Edge.A];
+		const FVector3f B = NodePositions[Edge.B];
+		FVector3f Direction = (B - A).GetSafeNormal();
+		if (Direction.IsZero())
+		{
+			Direction = FVector3f::XAxisVector;
+		}
+		const FVector3f Up = FMath::Abs(Direction.Z) < 0.99f ? FVector3f::ZAxisVector : FVector3f::XAxisVector;
+		const FVector3f U = FVector3f::CrossProduct(Direction, Up).GetSafeNormal() * (Edge.Thickness * 0.5f);
+		const FVector3f V = FVector3f::CrossProduct(Direction, U.GetSafeNormal()) * (Edge.Thickness * 0.5f);
+
+		const FVector3f Corners[GEdge_Vertices] = {A - U, A + U, B - U, B + U, A - V, A + V, B - V, B + V};
+		for (int32 i = 0; i < GEdge_Vertices; ++i)
+		{
+			VertexBuffers.PositionVertexBuffer.VertexPosition(Base + i) = Corners[i];
+			VertexBuffers.ColorVertexBuffer.VertexColor(Base + i) = Edge.Color;
+		}
+	}
+
+	// Copy the vertices of SortedEdges from the CPU copy to the GPU buffer, one lock per run of nearby edges
+	static void UploadEdgeRanges(FRHICommandListBase& RHICmdList, FRHIBuffer* Buffer, const void* Data,
+	                             const uint32 Stride, const TArray<int32>& SortedEdges)
+	{
+		if (!Buffer)
+			return;
+
+		const uint32 EdgeBytes = Stride * GEdge_Vertices;
+		int32 NumRanges = 0;
+		for (int32 First = 0; First < SortedEdges.Num();)
+		{
+			int32 Last = First;
+			while (Last + 1 < SortedEdges.Num() && SortedEdges[Last + 1] - SortedEdges[Last] <= GEdge_Range_Merge_Gap)
+			{
+				++Last;
+			}
+
+			const uint32 Offset = SortedEdges[First] * EdgeBytes;
+			const uint32 Size = (SortedEdges[Last] - SortedEdges[First] + 1) * EdgeBytes;
+			void* Locked = RHICmdList.LockBuffer(Buffer, Offset, Size, RLM_WriteOnly);
+			FMemory::Memcpy(Locked, static_cast<const uint8*>(Data) + Offset, Size);
+			RHICmdList.UnlockBuffer(Buffer);
+
+			++NumRanges;
+			First = Last + 1;
+		}
+		INC_DWORD_STAT_BY(STAT_ArtGraph_EdgeRangesUploaded, NumRanges);
+	}
+};
+
+UGraphEdgeComponent::UGraphEdgeComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+	CastShadow = false;
+	bUseEditorCompositing = true;
+	NodeBounds.Init();
+}
+
+void UGraphEdgeComponent::SetGraph(const TConstArrayView<FVector3f> InNodePositions,
+                                   const TConstArrayView<ForceDirected::FEdge> InEdges)
+{
+	NodePositions = InNodePositions;
+
+	// Invalid edges keep a hidden placeholder, so edge indices stay those of InEdges
+	Edges.Reset(InEdges.Num());
+	for (const ForceDirected::FEdge& Edge : InEdges)
+	{
+		if (!NodePositions.IsValidIndex(Edge.A) || !NodePositions.IsValidIndex(Edge.B))
+		{
+			Edges.AddDefaulted();
+			continue;
+		}
+
+		Edges.Add({Edge.A, Edge.B, DefaultStyle.Color, FMath::Max(DefaultStyle.Thickness, 0.f)});
+	}
+
+	// The new proxy starts from a full copy
+	DirtyNodes.Reset();
+	DirtyNodeFlags.Init(false, NodePositions.Num());
+	DirtyEdges.Reset();
+
+	RebuildBounds();
+	MarkRenderStateDirty();
+}
+
+void UGraphEdgeComponent::ClearGraph()
+{
+	SetGraph({}, {});
+}
+
+void UGraphEdgeComponent::SetNodePosition(const int32 Node, const FVector3f& Position)
+{
+	if (!NodePositions.IsValidIndex(Node) || NodePositions[Node] == Position)
+		return;
+
+	NodePositions[Node] = Position;
+	if (!DirtyNodeFlags[Node])
+	{
+		DirtyNodeFlags[Node] = true;
+		DirtyNodes.Add(Node);
+	}
+	MarkRenderDynamicDataDirty();
+
+	// Bounds only grow while a layout relaxes, so culling stays correct without refitting every frame
+	const FVector Location(Position);
+	if (!NodeBounds.IsInsideOrOn(Location))
+	{
+		NodeBounds += Location;
+		UpdateBounds();
+		MarkRenderTransformDirty();
+	}
+}
+
+void UGraphEdgeComponent::SetEdgeStyle(const int32 Edge, const FGraphEdgeStyle& Style)
+{
+	if (!Edges.IsValidIndex(Edge) || Edges[Edge].A == INDEX_NONE)
+		return;
+
+	Edges[Edge].Color = Style.Color;
+	Edges[Edge].Thickness = FMath::Max(Style.Thickness, 0.f);
+	DirtyEdges.AddUnique(Edge);
+	MarkRenderDynamicDataDirty();
+}
+
+FPrimitiveSceneProxy* UGraphEdgeComponent::CreateSceneProxy()
+{
+	if (Edges.IsEmpty())
+		return nullptr;
+
+	DirtyNodes.Reset();
+	DirtyNodeFlags.Init(false, NodePositions.Num());
+	DirtyEdges.Reset();
+	return new FGraphEdgeSceneProxy(this);
+}
+
+void UGraphEdgeComponent::GetUsedMaterials(TArray<UMaterialInterface*>& OutMaterials, bool bGetDebugMaterials) const
+{
+	OutMaterials.Add(GetEdgeMaterial());
+}
+
+UMaterialInterface* UGraphEdgeComponent::GetEdgeMaterial() const
+{
+	// Unlit and colored by the vertices, which carry each edge's style
+	UMaterialInterface* Material = GEngine ? GEngine->VertexColorMaterial : nullptr;
+	return Material ? Material : UMaterial::GetDefaultMaterial(MD_Surface);
+}
+
+FBoxSphereBounds UGraphEdgeComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	// Positions are already in world space
+	return NodeBounds.IsValid
+		       ? FBoxSphereBounds(NodeBounds)
+		       : FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+}
+
+void UGraphEdgeComponent::SendRenderDynamicData_Concurrent()
+{
+	Super::SendRenderDynamicData_Concurrent();
+
+	SCOPE_CYCLE_COUNTER(STAT_ArtGraph_EdgeUpdate);
+	for (const int32 Node : DirtyNodes)
+	{
+		DirtyNodeFlags[Node] = false;
+	}
+
+	FGraphEdgeSceneProxy* EdgeProxy = static_cast<FGraphEdgeSceneProxy*>(SceneProxy);
+	if (EdgeProxy && (!DirtyNodes.IsEmpty() || !DirtyEdges.IsEmpty()))
+	{
+		FGraphEdgeSceneProxy::FUpdate Update;
+		Update.Nodes = MoveTemp(DirtyNodes);
+		Update.Positions.Reserve(Update.Nodes.Num());
+		for (const int32 Node : Update.Nodes)
+		{
+			Update.Positions.Add(NodePositions[Node]);
+		}
+		Update.Edges = MoveTemp(DirtyEdges);
+		Update.EdgeInstances.Reserve(Update.Edges.Num());
+		for (const int32 Edge : Update.Edges)
+		{
+			Update.EdgeInstances.Add(Edges[Edge]);
+		}
+		INC_DWORD_STAT_BY(STAT_ArtGraph_EdgeNodesUpdated, Update.Nodes.Num());
+
+		ENQUEUE_RENDER_COMMAND(UpdateGraphEdges)(
+			[EdgeProxy, Update = MoveTemp(Update)](FRHICommandListImmediate& RHICmdList)
+			{
+				EdgeProxy->ApplyUpdate_RenderThread(RHICmdList, Update);
+			});
+	}
+
+	DirtyNodes.Reset();
+	DirtyEdges.Reset();
+}
+
+void UGraphEdgeComponent::RebuildBounds()
+{
+	NodeBounds.Init();
+	for (const FVector3f& Position : NodePositions)
+	{
+		NodeBounds += FVector(Position);
+	}
+	UpdateBounds();
+}
@@ -1,20 +1,88 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "ArtGraph/GraphUntangling.h"
-#include "Kismet/GameplayStatics.h"
+#include "ArtGraph/ArtGraphLayoutCache.h"
+#include "ArtGraph/ArtGraphLayoutSubsystem.h"
+#include "ArtGraph/ArtGraphStats.h"
+#include "ArtGraph/ArtGraphSubsystem.h"
 #include "ArtGraph/Untangleable.h"
-#include "DrawDebugHelpers.h"
+#include "ArtGraph/UntangleableRegistry.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Layout/LayoutKernels.h"
 
 namespace
 {
 	constexpr TCHAR GStatic_Mesh_Asset_Path[] = TEXT(
 		"/Engine/Functions/Engine_MaterialFunctions02/ExampleContent/PivotPainter2/SimplePivotPainterExample.SimplePivotPainterExample");
+
+	// Largest relative difference tolerated between the SIMD and scalar repulsion kernels
+	constexpr float GSimd_Kernel_Tolerance = 1e-3f;
+
+	// Game time the layout may fall behind by before older iterations are dropped, so a long hitch doesn't turn
+	// into a backlog that takes many frames to work off
+	constexpr double GMax_Step_Backlog_Seconds = 0.25;
+
+	TAutoConsoleVariable<bool> CVarArtGraphDebugMessages(
+		TEXT("ArtGraph.DebugMessages"), false,
+		TEXT("Print an on-screen message for every node the layout moves. Slow, only meant for small graphs."));
 }
 
+// The solver phases run in the engine-free layout core, which times them itself and reports back after each step
+DECLARE_CYCLE_STAT(TEXT("Gather Positions"), STAT_ArtGraph_Gather, STATGROUP_ArtGraph);
+DECLARE_CYCLE_STAT(TEXT("Repulsion"), STAT_ArtGraph_Repulsion, STATGROUP_ArtGraph);
+DECLARE_CYCLE_STAT(TEXT("Attraction"), STAT_ArtGraph_Attraction, STATGROUP_ArtGraph);
+DECLARE_CYCLE_STAT(TEXT("Apply Displacements"), STAT_ArtGraph_Apply, STATGROUP_ArtGraph);
+DECLARE_CYCLE_STAT(TEXT("Write Back Positions"), STAT_ArtGraph_WriteBack, STATGROUP_ArtGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Node Transforms Pushed"), STAT_ArtGraph_TransformsPushed, STATGROUP_ArtGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Layout Iterations"), STAT_ArtGraph_Iterations, STATGROUP_ArtGraph);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Energy"), STAT_ArtGraph_Energy, STATGROUP_ArtGraph);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Temperature"), STAT_ArtGraph_Temperature, STATGROUP_ArtGraph);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Max Displacement"), STAT_ArtGraph_MaxDisplacement, STATGROUP_ArtGraph);
+
+TRACE_DECLARE_FLOAT_COUNTER(ArtGraph_Energy, TEXT("ArtGraph/Energy"));
+TRACE_DECLARE_FLOAT_COUNTER(ArtGraph_Temperature, TEXT("ArtGraph/Temperature"));
+TRACE_DECLARE_FLOAT_COUNTER(ArtGraph_MaxDisplacement, TEXT("ArtGraph/MaxDisplacement"));
+
 AGraphUntangling::AGraphUntangling()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
+	LayoutAlgorithm = EGraphLayoutAlgorithm::FruchtermanReingold;
+	RepulsionMethod = EGraphRepulsionMethod::BarnesHut;
+	RepulsionCutoff = 1000.f;
+	BarnesHutTheta = 0.5f;
+	StressIterations = 30;
+	StressPivots = 50;
+	NumWorkerThreads = 0;
+	bUseSimdKernels = true;
+	bSolveAsynchronously = false;
+	AsyncIterationsPerTask = 1;
+	IterationsPerSecond = 60.f;
+	FrameBudgetMs = 4.f;
+	LayoutPriority = 0;
+	WriteBackThreshold = 0.1f;
+	ConvergenceThreshold = 0.5f;
+	ConvergenceIterations = 30;
+	bUseLayoutCache = true;
+	bIncrementalRelayout = true;
+	IncrementalHops = 2;
+	WarmStartTemperature = 3.f;
+	AsyncIteration = 0;
+	bStepStatsCaptured = false;
+	bPositionsSeeded = false;
+	bLayoutConverged = false;
+	bLayoutIdle = false;
+	bGraphDirty = false;
+	bNodeActorsDirty = false;
+	BuiltGraphGeneration = 0;
+	StepAccumulator = 0.0;
+	bConvergenceResetPending = false;
+	bWritingPositions = false;
+
 	// Create StaticMeshComponent and set as root
 	PreviewMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("StaticMeshComponent"));
 	SetRootComponent(PreviewMesh);
@@ -22,6 +90,9 @@ AGraphUntangling::AGraphUntangling()
 	// Set PreviewMesh to be hidden in game
 	PreviewMesh->SetHiddenInGame(true);
 
+	EdgeRenderer = CreateDefaultSubobject<UGraphEdgeComponent>(TEXT("EdgeRenderer"));
+	EdgeRenderer->SetupAttachment(PreviewMesh);
+
 	static ConstructorHelpers::FObjectFinder<UStaticMesh> MeshAsset(GStatic_Mesh_Asset_Path);
 	if (MeshAsset.Succeeded())
 	{
@@ -39,24 +110,150 @@ void AGraphUntangling::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Stepped along with every other layout in the world instead of ticking on its own
+	if (UArtGraphLayoutSubsystem* Layouts = GetWorld()->GetSubsystem<UArtGraphLayoutSubsystem>())
+	{
+		Layouts->RegisterLayout(this);
+		LayoutSubsystem = Layouts;
+		SetActorTickEnabled(false);
+	}
+
 	// Parameters
 	RefreshUntangleableActors();
 	InitializeGraphParameters();
+
+	// Untangleables coming and going may complete or break the graph
+	if (UUntangleableRegistry* Registry = GetUntangleableRegistry())
+	{
+		RegistryAddedHandle = Registry->OnActorRegistered.AddUObject(
+			this, &AGraphUntangling::OnUntangleableRegistered);
+		RegistryRemovedHandle = Registry->OnActorUnregistered.AddUObject(
+			this, &AGraphUntangling::OnUntangleableUnregistered);
+	}
 }
 
-void AGraphUntangling::OnConstruction(const FTransform& Transform)
+void AGraphUntangling::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::OnConstruction(Transform);
-	DrawAdjacencyLines(10.0f, false, 3.0f, FColor::Red);
+	// The background task references this actor
+	WaitForAsyncSolve();
+
+	if (UArtGraphLayoutSubsystem* Layouts = LayoutSubsystem.Get())
+	{
+		Layouts->UnregisterLayout(this);
+	}
+	LayoutSubsystem.Reset();
+
+	if (UUntangleableRegistry* Registry = GetUntangleableRegistry())
+	{
+		Registry->OnActorRegistered.Remove(RegistryAddedHandle);
+		Registry->OnActorUnregistered.Remove(RegistryRemovedHandle);
+	}
+	RegistryAddedHandle.Reset();
+	RegistryRemovedHandle.Reset();
+	UnbindNodeActors();
+	UnbindTargetedGraph();
+	if (TargetedGraphLoadHandle.IsValid())
+	{
+		TargetedGraphLoadHandle->CancelHandle();
+		TargetedGraphLoadHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AGraphUntangling::RefreshUntangleableActors()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGraphUntangling::RefreshUntangleableActors);
 	UE_LOG(LogTemp, Log, TEXT("AGraphUntangling::RefreshUntangleableActors."));
-	FindImplementorsWithTags();
-	CastToUntangleableActors();
-	UpdateActorToIndexMap();
+	WaitForAsyncSolve();
+	AsyncSnapshots.Reset();
+
+	// With a layout in place, keep it and only relax around what changed
+	const bool bIncremental = bIncrementalRelayout && bPositionsSeeded && NumNodes > 0;
+	TMap<const AActor*, int32> PreviousNodeIndices;
+	if (bIncremental)
+	{
+		PreviousNodeIndices.Reserve(NodeActors.Num());
+		for (int32 v = 0; v < NodeActors.Num(); ++v)
+		{
+			PreviousNodeIndices.Add(NodeActors[v], v);
+		}
+	}
+	bPositionsSeeded = false;
+
+	UnbindNodeActors();
+
+	// An unloaded graph is requested now and picked up by the first tick after it arrives
+	RequestTargetedGraph();
+
+	std::vector<ForceDirected::FEdge> Edges;
+	FindImplementorsWithTags(Edges);
+
+	// Anything reported until now is part of the refreshed topology
+	bGraphDirty = false;
+	bNodeActorsDirty = false;
+	ExternallyMovedNodes.Empty();
+	BindTargetedGraph();
+	BindNodeActors();
+
+	// Compile the topology once; from here on the layout only walks integer indices
+	if (bIncremental)
+	{
+		UpdateGraphIncrementally(Edges, PreviousNodeIndices);
+	}
+	else
+	{
+		Solver.SetGraph(NodeActors.Num(), Edges);
+	}
+	NumNodes = Solver.GetNumNodes();
+	UE_LOG(LogTemp, Log,
+	       TEXT("AGraphUntangling::RefreshUntangleableActors: Compiled %d nodes and %d edges (%llu bytes)."),
+	       NumNodes, Solver.GetGraph().GetNumEdges(), static_cast<uint64>(GetGraphAllocatedSize()));
+
 	FormatDebugUntangleableObjects();
+	UpdateEdgeRenderer();
+
+	// The new topology starts hot and has to settle again
+	WakeLayout();
+}
+
+void AGraphUntangling::UpdateGraphIncrementally(const std::vector<ForceDirected::FEdge>& Edges,
+                                                const TMap<const AActor*, int32>& PreviousNodeIndices)
+{
+	const int32 NumNewNodes = NodeActors.Num();
+	std::vector<int32_t> PreviousNodes(NumNewNodes, ForceDirected::InvalidIndex);
+	ForceDirected::FLayoutBuffers HostPositions;
+	HostPositions.SetNumZeroed(NumNewNodes);
+	LastWrittenPositions.SetNumUninitialized(NumNewNodes);
+
+	for (int32 v = 0; v < NumNewNodes; ++v)
+	{
+		const AActor* NodeActor = NodeActors[v];
+		if (const int32* Previous = PreviousNodeIndices.Find(NodeActor))
+		{
+			PreviousNodes[v] = *Previous;
+		}
+
+		const FVector3f Location = NodeActor ? FVector3f(NodeActor->GetActorLocation()) : FVector3f::ZeroVector;
+		HostPositions.Set(v, ForceDirected::FVec3(Location.X, Location.Y, Location.Z));
+		LastWrittenPositions[v] = Location;
+	}
+
+	Solver.SetSettings(MakeSolverSettings());
+	const int32 NumRelaxed = Solver.UpdateGraph(NumNewNodes, Edges, PreviousNodes, HostPositions);
+
+	// The solver carries its positions over, actors are only written to from here on
+	AsyncIteration = 0;
+	bPositionsSeeded = true;
+
+	UE_LOG(LogTemp, Log,
+	       TEXT("AGraphUntangling::UpdateGraphIncrementally: Relaxing %d of %d nodes around the change."),
+	       NumRelaxed, NumNewNodes);
+}
+
+SIZE_T AGraphUntangling::GetGraphAllocatedSize() const
+{
+	return NodeActors.GetAllocatedSize() + Solver.GetGraph().GetAllocatedSize();
 }
 
 // Find actors that implement Untangleable and match the required tags.
@@ -66,431 +263,938 @@ void AGraphUntangling::RefreshUntangleableActors()
 //
 // The actor must have the primary tag from the graph and all secondary tags to
 // be considered a match.
-void AGraphUntangling::FindImplementorsWithTags()
+void AGraphUntangling::FindImplementorsWithTags(std::vector<ForceDirected::FEdge>& OutEdges)
 {
-	// If TargetGraph is not set, clear the list and the last constructed graph reference.
-	if (!TargetedGraph)
+	NodeActors.Empty();
+	NodeActorTags.Empty();
+	UnresolvedNodeTags.Empty();
+	OutEdges.clear();
+
+	// If TargetGraph is not set or still loading, leave the graph empty.
+	UGraphElement* Graph = TargetedGraph.Get();
+	if (!Graph)
 	{
 		UE_LOG(LogTemp, Log,
 		       TEXT(
-			       "AGraphUntangling::FindImplementorsWithTags: TargetGraph is null. Clearing UntangleableAdjacencyList."
+			       "AGraphUntangling::FindImplementorsWithTags: TargetGraph is null or not loaded yet. Clearing the untangled graph."
 		       ));
-		UntangleableAdjacencyList.Empty();
 		return;
 	}
 
-	// Explicitly update the adjacency list before using it
-	TargetedGraph->UpdateAdjacencyList();
-
-	UntangleableAdjacencyList.Empty();
-	const TArray<TArray<FGameplayTag>>& AdjacencyList = TargetedGraph->GetAdjacencyList();
+	// Rebuilt on demand if the graph or anything it references changed
+	const FGraphAdjacencyView Adjacency = Graph->GetAdjacencyView();
+	BuiltGraphGeneration = Adjacency.Generation;
 
-	if (AdjacencyList.IsEmpty())
+	if (Adjacency.Num() == 0)
 	{
 		UE_LOG(LogTemp, Warning,
 		       TEXT(
 			       "AGraphUntangling::FindImplementorsWithTags: TargetGraph %s has an empty adjacency list. Skipping."),
-		       *TargetedGraph->GetName());
+		       *Graph->GetName());
 		return;
 	}
 
-	// Find all actors in the current level that implement the Untangleable interface
-	TArray<AActor*> FoundActors;
-	UGameplayStatics::GetAllActorsWithInterface(GetWorld(), UUntangleable::StaticClass(), FoundActors);
-
-	if (FoundActors.Num() == 0)
+	// Actors implementing the Untangleable interface, indexed by tag as they enter and leave the world
+	UUntangleableRegistry* Registry = GetUntangleableRegistry();
+	if (!Registry)
 	{
 		UE_LOG(LogTemp, Warning,
-		       TEXT(
-			       "AGraphUntangling::FindImplementorsWithTags: No actors implementing Untangleable interface found in the level."
-		       ));
+		       TEXT("AGraphUntangling::FindImplementorsWithTags: No Untangleable registry in this world. Skipping."));
 		return;
 	}
 
 	bool bConstructionSuccessful = true; // Track if construction completes without missing actors
-	UntangleableAdjacencyList.Reserve(AdjacencyList.Num());
+	NodeActors.Reserve(Adjacency.Num());
 
-	// Iterate through the desired graph structure (Adjacency List)
-	for (const TArray<FGameplayTag>& NodeConnections : AdjacencyList)
+	// Every tag that can appear as a neighbor is a node of the graph, so resolving the nodes resolves the
+	// whole graph. Graph node IDs map to solver nodes, or INDEX_NONE when no actor matched.
+	TArray<int32> GraphToNode;
+	GraphToNode.Init(INDEX_NONE, Adjacency.Num());
+	for (int32 GraphNode = 0; GraphNode < Adjacency.Num(); ++GraphNode)
 	{
-		TArray<TScriptInterface<IUntangleable>> InnerArray;
-		InnerArray.Reserve(NodeConnections.Num());
+		const FGameplayTag& RequiredPrimaryTag = Adjacency.NodeTags[GraphNode];
+		if (!RequiredPrimaryTag.IsValid())
+		{
+			UE_LOG(LogTemp, Warning,
+			       TEXT(
+				       "AGraphUntangling::FindImplementorsWithTags: Encountered invalid tag in TargetGraph's adjacency list. Skipping."
+			       ));
+			continue;
+		}
 
-		// For each tag (node or neighbor) in the graph structure
-		for (const FGameplayTag& RequiredPrimaryTag : NodeConnections)
+		if (AActor* Actor = Registry->FindActor(RequiredPrimaryTag, SecondaryTags))
 		{
-			if (!RequiredPrimaryTag.IsValid())
-			{
-				UE_LOG(LogTemp, Warning,
-				       TEXT(
-					       "AGraphUntangling::FindImplementorsWithTags: Encountered invalid tag in TargetGraph's adjacency list. Skipping."
-				       ));
-				// SAFETY: DO NOT add null pointer for the missing actor here.
-				continue;
-			}
+			UE_LOG(LogTemp, Verbose,
+			       TEXT("AGraphUntangling::FindImplementorsWithTags: Matched Actor %s for Primary Tag %s (Required Secondary Tags: %s)"),
+			       *Actor->GetName(), *RequiredPrimaryTag.ToString(), *SecondaryTags.ToString());
+			GraphToNode[GraphNode] = NodeActors.Add(Actor);
+			NodeActorTags.Add(RequiredPrimaryTag);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning,
+			       TEXT(
+				       "AGraphUntangling::FindImplementorsWithTags: Could not find any actor matching required tags: Primary=%s, Secondary=%s"
+			       ),
+			       *RequiredPrimaryTag.ToString(), *SecondaryTags.ToString());
+			UnresolvedNodeTags.Add(RequiredPrimaryTag);
+			bConstructionSuccessful = false; // Mark as potentially incomplete
+		}
+	}
 
-			// Define the required tags for the actor: the primary tag from the graph + ALL secondary tags
-			FGameplayTagContainer RequiredTags;
-			RequiredTags.AddTag(RequiredPrimaryTag);
-			RequiredTags.AppendTags(SecondaryTags); // Add all secondary tags
+	// Translate neighbor IDs into node indices. Missing actors simply contribute no edges.
+	OutEdges.reserve(Adjacency.Neighbors.Num());
+	for (int32 GraphNode = 0; GraphNode < Adjacency.Num(); ++GraphNode)
+	{
+		const int32 Node = GraphToNode[GraphNode];
+		if (Node == INDEX_NONE)
+			continue;
 
-			bool bFoundMatchingActor = false;
-			// Iterate through all found actors to find one that matches the required tags
-			for (AActor* Actor : FoundActors)
-			{
-				if (!Actor)
-				{
-					UE_LOG(LogTemp, Warning,
-					       TEXT("AGraphUntangling::FindImplementorsWithTags: Null actor found in FoundActors array"));
-					continue;
-				}
-				if (Actor->GetClass()->ImplementsInterface(UUntangleable::StaticClass()))
-				{
-					FGameplayTagContainer ActorTags = IUntangleable::Execute_GetTags(Actor);
-
-					// Check if the actor has ALL the required tags
-					if (ActorTags.HasAll(RequiredTags))
-					{
-						// Found a matching actor
-						TScriptInterface<IUntangleable> UntangleableActor;
-						UntangleableActor.SetObject(Actor);
-
-						InnerArray.Add(UntangleableActor);
-						UE_LOG(LogTemp, Log,
-						       TEXT(
-							       "AGraphUntangling::FindImplementorsWithTags: Matched Actor %s for Primary Tag %s (Required Secondary Tags: %s)"
-						       ),
-						       *Actor->GetName(), *RequiredPrimaryTag.ToString(), *SecondaryTags.ToString());
-						bFoundMatchingActor = true;
-						break; // Stop searching for actors for this specific RequiredPrimaryTag
-					}
-				}
-				else
-				{
-					UE_LOG(LogTemp, Warning,
-					       TEXT(
-						       "AGraphUntangling::FindImplementorsWithTags: Actor %s was returned by GetAllActorsWithInterface but doesn't implement Untangleable"
-					       ), *Actor->GetName());
-				}
-			} // End loop through FoundActors
-
-			if (!bFoundMatchingActor)
+		for (const int32 GraphNeighbor : Adjacency.GetNeighbors(GraphNode))
+		{
+			if (GraphToNode[GraphNeighbor] != INDEX_NONE)
 			{
-				UE_LOG(LogTemp, Warning,
-				       TEXT(
-					       "AGraphUntangling::FindImplementorsWithTags: Could not find any actor matching required tags: Primary=%s, Secondary=%s"
-				       ),
-				       *RequiredPrimaryTag.ToString(), *SecondaryTags.ToString());
-				bConstructionSuccessful = false; // Mark as potentially incomplete
-				// SAFETY: DO NOT add a null pointer for the missing actor here.
+				OutEdges.push_back({Node, GraphToNode[GraphNeighbor]});
 			}
-		} // End loop through NodeConnections (tags)
-
-		UntangleableAdjacencyList.Add(InnerArray);
-	} // End loop through AdjacencyList
+		}
+	}
 
 	if (bConstructionSuccessful)
 	{
 		UE_LOG(LogTemp, Log,
 		       TEXT(
-			       "AGraphUntangling::FindImplementorsWithTags: Successfully constructed UntangleableAdjacencyList with %d nodes for graph %s."
+			       "AGraphUntangling::FindImplementorsWithTags: Successfully matched %d nodes for graph %s."
 		       ),
-		       UntangleableAdjacencyList.Num(), *TargetedGraph->GetName());
+		       NodeActors.Num(), *Graph->GetName());
 	}
 	else
 	{
 		UE_LOG(LogTemp, Warning,
 		       TEXT(
-			       "AGraphUntangling::FindImplementorsWithTags: Finished constructing UntangleableAdjacencyList for graph %s, but some actors were missing."
+			       "AGraphUntangling::FindImplementorsWithTags: Finished matching nodes for graph %s, but some actors were missing."
 		       ),
-		       *TargetedGraph->GetName());
+		       *Graph->GetName());
 	}
 }
 
-void AGraphUntangling::CastToUntangleableActors()
+UUntangleableRegistry* AGraphUntangling::GetUntangleableRegistry() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<UUntangleableRegistry>() : nullptr;
+}
+
+void AGraphUntangling::InitializeGraphParameters()
+{
+	KConstant = KConstantUser > 0.f ? KConstantUser : 15.f;
+	UE_LOG(LogTemp, Log, TEXT("AGraphUntangling::InitializeGraphParameters: KConstant: %f"), KConstant);
+
+	WaitForAsyncSolve();
+
+	NumNodes = Solver.GetNumNodes();
+
+	Solver.SetParallelFor([](const int32_t NumTasks, const std::function<void(int32_t)>& Body)
+	{
+		ParallelFor(NumTasks, [&Body](const int32 Task) { Body(Task); });
+	});
+	Solver.SetSettings(MakeSolverSettings());
+	Solver.ResetTemperature();
+
+	UE_LOG(LogTemp, Log,
+	       TEXT("AGraphUntangling::InitializeGraphParameters: NumNodes=%d, NumEdges=%d, Temperature=%.2f"),
+	       NumNodes, Solver.GetGraph().GetNumEdges(), Solver.GetTemperature());
+}
+
+void AGraphUntangling::FormatDebugUntangleableObjects()
 {
-	// Clear the existing ActorAdjacencyList
-	ActorAdjacencyList.Empty();
+	DebugAdjacencyList.Empty(); // Clear the debug string
 
-	// Populate ActorAdjacencyList based on UntangleableAdjacencyList
-	for (const TArray<TScriptInterface<IUntangleable>>& UntangleableInnerList : UntangleableAdjacencyList)
+	const ForceDirected::FLayoutGraph& Graph = Solver.GetGraph();
+	for (int32 v = 0; v < NodeActors.Num(); ++v)
 	{
-		TArray<AActor*> ActorInnerList;
-		for (const TScriptInterface<IUntangleable>& UntangleableItem : UntangleableInnerList)
+		// Use the actor's name directly
+		const FString KeyName = NodeActors[v] ? NodeActors[v]->GetName() : TEXT("NULL_NODE");
+		DebugAdjacencyList += FString::Printf(TEXT("%s -> ["), *KeyName);
+
+		for (const int32_t* Neighbor = Graph.NeighborsBegin(v); Neighbor != Graph.NeighborsEnd(v); ++Neighbor)
 		{
-			if (AActor* ActorItem = Cast<AActor>(UntangleableItem.GetObject()))
-			{
-				ActorInnerList.Add(ActorItem);
-			}
-			else
+			const AActor* NeighborActor = NodeActors[*Neighbor];
+			DebugAdjacencyList += NeighborActor ? NeighborActor->GetName() : TEXT("NULL");
+
+			if (Neighbor + 1 != Graph.NeighborsEnd(v))
 			{
-				// Warn if the cast fails, though an IUntangleable should ideally be an AActor or derived from it
-				UE_LOG(LogTemp, Warning, TEXT("RefreshUntangleableActors: UntangleableItem %s is not an AActor."),
-				       *UntangleableItem.GetObject()->GetName());
+				DebugAdjacencyList += TEXT(", ");
 			}
 		}
-		ActorAdjacencyList.Add(ActorInnerList);
+		DebugAdjacencyList += TEXT("]");
+
+		// Add newline for readability, check if it's not the last element
+		if (v < NodeActors.Num() - 1)
+		{
+			DebugAdjacencyList += TEXT("\n\n");
+		}
 	}
 }
 
-void AGraphUntangling::UpdateActorToIndexMap()
+
+void AGraphUntangling::UpdateEdgeRenderer()
 {
-	ActorToIndexMap.Empty();
-	for (int32 i = 0; i < ActorAdjacencyList.Num(); ++i)
+	TArray<FVector3f> Locations;
+	Locations.Reserve(NodeActors.Num());
+	for (const AActor* NodeActor : NodeActors)
 	{
-		if (ActorAdjacencyList[i].Num() > 0 && ActorAdjacencyList[i][0])
-		{
-			ActorToIndexMap.Add(ActorAdjacencyList[i][0], i);
-		}
+		Locations.Add(NodeActor ? FVector3f(NodeActor->GetActorLocation()) : FVector3f::ZeroVector);
 	}
+
+	const std::vector<ForceDirected::FEdge>& Edges = Solver.GetGraph().GetEdges();
+	EdgeRenderer->SetGraph(Locations, MakeArrayView(Edges.data(), static_cast<int32>(Edges.size())));
 }
 
-void AGraphUntangling::InitializeGraphParameters()
+int32 AGraphUntangling::GetNumForceTasks() const
 {
-	KConstant = KConstantUser > 0.f ? KConstantUser : 15.f;
-	KSquared = KConstant * KConstant;
-	UE_LOG(LogTemp, Log, TEXT("AGraphUntangling::InitializeGraphParameters: KConstant: %f, KSquared: %f"), KConstant,
-	       KSquared);
+	if (NumWorkerThreads == 1 || !FApp::ShouldUseThreadingForPerformance())
+		return 1;
+
+	// 0 means one task per available core, the game thread included
+	const int32 Requested = NumWorkerThreads > 0
+		                        ? NumWorkerThreads
+		                        : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	return FMath::Clamp(Requested, 1, FMath::Max(1, static_cast<int32>(NumNodes)));
+}
 
-	NumNodes = ActorAdjacencyList.Num();
-	Temperature = 10.f * FMath::Sqrt(static_cast<float>(NumNodes));
-	Positions.SetNum(NumNodes);
-	Movements.SetNumZeroed(NumNodes);
+ForceDirected::FSolverSettings AGraphUntangling::MakeSolverSettings() const
+{
+	ForceDirected::FSolverSettings Settings;
+	Settings.Algorithm = LayoutAlgorithm == EGraphLayoutAlgorithm::StressMajorization
+		                     ? ForceDirected::ELayoutAlgorithm::StressMajorization
+		                     : ForceDirected::ELayoutAlgorithm::FruchtermanReingold;
+	Settings.KConstant = KConstant;
+	switch (RepulsionMethod)
+	{
+	case EGraphRepulsionMethod::Exact:
+		Settings.RepulsionMethod = ForceDirected::ERepulsionMethod::Exact;
+		break;
+	case EGraphRepulsionMethod::SpatialHash:
+		Settings.RepulsionMethod = ForceDirected::ERepulsionMethod::SpatialHash;
+		break;
+	default:
+		Settings.RepulsionMethod = ForceDirected::ERepulsionMethod::BarnesHut;
+		break;
+	}
+	Settings.Theta = BarnesHutTheta;
+	Settings.RepulsionCutoff = FMath::Max(RepulsionCutoff, 1.f);
+	Settings.NumTasks = GetNumForceTasks();
+	Settings.bUseSimd = bUseSimdKernels;
+	Settings.ConvergenceThreshold = ConvergenceThreshold;
+	Settings.ConvergenceIterations = ConvergenceIterations;
+	Settings.IncrementalHops = FMath::Max(IncrementalHops, 0);
+	Settings.StressIterations = FMath::Max(StressIterations, 1);
+	Settings.StressPivots = FMath::Max(StressPivots, 0);
+	return Settings;
+}
+
+void AGraphUntangling::ValidateSimdKernel()
+{
+	if (NumNodes == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AGraphUntangling::ValidateSimdKernel: No layout initialized, nothing to compare."));
+		return;
+	}
 
+	WaitForAsyncSolve();
+	SyncSolverWithActors();
+	const float MaxError = ForceDirected::FLayoutKernels::CompareRepulsionKernels(
+		Solver.GetPositions(), KConstant * KConstant, FMath::Max(RepulsionCutoff, 1.f));
 	UE_LOG(LogTemp, Log,
-	       TEXT(
-		       "AGraphUntangling::InitializeGraphParameters: NumNodes=%d, Temperature=%.2f, PositionsSize=%d, MovementsSize=%d"
-	       ),
-	       NumNodes, Temperature, Positions.Num(), Movements.Num());
+	       TEXT("AGraphUntangling::ValidateSimdKernel: %d nodes, max relative error between SIMD and scalar repulsion: %g"),
+	       NumNodes, MaxError);
+	if (MaxError > GSimd_Kernel_Tolerance)
+	{
+		UE_LOG(LogTemp, Error, TEXT("AGraphUntangling::ValidateSimdKernel: Error exceeds tolerance %g."),
+		       GSimd_Kernel_Tolerance);
+	}
 }
 
-void AGraphUntangling::FormatDebugUntangleableObjects()
+void AGraphUntangling::GatherPositions()
 {
-	DebugAdjacencyList.Empty(); // Clear the debug string
+	SCOPE_CYCLE_COUNTER(STAT_ArtGraph_Gather);
 
-	for (const TArray<AActor*>& NodeConnections : ActorAdjacencyList)
+	ForceDirected::FLayoutBuffers& Positions = Solver.GetPositions();
+	for (int32 i = 0; i < NumNodes; ++i)
 	{
-		FString KeyName = TEXT("INVALID_NODE"); // Default if node is missing/invalid
-		if (NodeConnections.Num() > 0)
+		FVector3f Location = FVector3f::ZeroVector;
+		if (const AActor* NodeActor = NodeActors[i])
 		{
-			if (NodeConnections[0])
-			{
-				// Use the actor's name directly
-				KeyName = NodeConnections[0]->GetName();
-			}
-			else
-			{
-				KeyName = TEXT("NULL_NODE"); // Node entry exists but is null
-			}
+			Location = FVector3f(NodeActor->GetActorLocation());
+		}
+		Positions.Set(i, ForceDirected::FVec3(Location.X, Location.Y, Location.Z));
+	}
+}
 
-			DebugAdjacencyList += FString::Printf(TEXT("%s -> ["), *KeyName);
+void AGraphUntangling::SeedPositions()
+{
+	GatherPositions();
 
-			// Start from index 1 to get neighbors
-			for (int32 i = 1; i < NodeConnections.Num(); ++i)
-			{
-				if (NodeConnections[i])
-				{
-					// Use the neighbor actor's name directly
-					FString NeighborName = NodeConnections[i]->GetName();
-					DebugAdjacencyList += NeighborName;
-				}
-				else
-				{
-					DebugAdjacencyList += TEXT("NULL"); // Handle null neighbor entries
-				}
-
-				if (i < NodeConnections.Num() - 1)
-				{
-					DebugAdjacencyList += TEXT(", ");
-				}
-			}
-			DebugAdjacencyList += TEXT("]");
-		}
-		else
-		{
-			// Handle case where the inner array itself is empty
-			DebugAdjacencyList += TEXT("EMPTY_NODE_ARRAY");
-		}
+	LastWrittenPositions.SetNumUninitialized(NumNodes);
+	const ForceDirected::FLayoutBuffers& Positions = Solver.GetPositions();
+	for (int32 v = 0; v < NumNodes; ++v)
+	{
+		const ForceDirected::FVec3 Position = Positions.Get(v);
+		LastWrittenPositions[v] = FVector3f(Position.X, Position.Y, Position.Z);
+	}
 
-		// Add newline for readability, check if it's not the last element
-		if (&NodeConnections != &ActorAdjacencyList.Last())
-		{
-			DebugAdjacencyList += TEXT("\n\n");
-		}
+	AsyncIteration = 0;
+	bPositionsSeeded = true;
+
+	// Put the actors where this graph settled last time right away
+	if (ApplyCachedLayout())
+	{
+		WritePositionsToActors(Solver.GetPositions());
 	}
 }
 
+uint64 AGraphUntangling::ComputeLayoutCacheKey(std::vector<int32_t>& OutCanonicalIndex) const
+{
+	const int32 NumTagged = NodeActorTags.Num();
+	if (NumTagged != static_cast<int32>(NumNodes))
+		return 0;
+
+	// Layout nodes are numbered in the order their actors were matched, which depends on registration order,
+	// and a tag's in-memory identity is an index into the tag table of this session. Only the tag names are the
+	// same in every session, so nodes are renumbered by name and the names themselves are hashed.
+	TArray<FString> TagNames;
+	TagNames.Reserve(NumTagged);
+	for (const FGameplayTag& Tag : NodeActorTags)
+	{
+		TagNames.Add(Tag.ToString());
+	}
+
+	TArray<int32> Order;
+	Order.SetNumUninitialized(NumTagged);
+	for (int32 v = 0; v < NumTagged; ++v)
+	{
+		Order[v] = v;
+	}
+	Order.Sort([&TagNames](const int32 A, const int32 B) { return TagNames[A] < TagNames[B]; });
+
+	ForceDirected::FLayoutHasher Hasher;
+	OutCanonicalIndex.assign(NumTagged, 0);
+	for (int32 Rank = 0; Rank < NumTagged; ++Rank)
+	{
+		OutCanonicalIndex[Order[Rank]] = Rank;
+		const FTCHARToUTF8 Name(*TagNames[Order[Rank]]);
+		Hasher.AddString(std::string_view(Name.Get(), Name.Length()));
+	}
+
+	TArray<FString> SecondaryTagNames;
+	for (const FGameplayTag& Tag : SecondaryTags)
+	{
+		SecondaryTagNames.Add(Tag.ToString());
+	}
+	SecondaryTagNames.Sort();
+	for (const FString& TagName : SecondaryTagNames)
+	{
+		const FTCHARToUTF8 Name(*TagName);
+		Hasher.AddString(std::string_view(Name.Get(), Name.Length()));
+	}
+	Hasher.AddInt(static_cast<int64_t>(LayoutAlgorithm));
+	Hasher.AddFloat(KConstant);
+
+	return ForceDirected::HashGraphTopology(Solver.GetGraph(), OutCanonicalIndex, Hasher.Get());
+}
 
-void AGraphUntangling::DrawAdjacencyLines(const float LineThickness, const bool PersistentLines,
-                                          const float LineDuration,
-                                          const FColor LineColor)
+bool AGraphUntangling::ApplyCachedLayout()
 {
-	const UWorld* World = GetWorld();
-	if (!World)
+	UArtGraphLayoutCache* LayoutCache = bUseLayoutCache && GEngine ? GEngine->GetEngineSubsystem<UArtGraphLayoutCache>() : nullptr;
+	if (!LayoutCache || NumNodes == 0)
+		return false;
+
+	std::vector<int32_t> CanonicalIndex;
+	const uint64 Key = ComputeLayoutCacheKey(CanonicalIndex);
+	ForceDirected::FLayoutBuffers Cached;
+	if (!Key || !LayoutCache->FindLayout(Key, static_cast<int32>(NumNodes), Cached))
+	{
+		UE_LOG(LogTemp, Log, TEXT("AGraphUntangling::ApplyCachedLayout: No cached layout for %s, solving from scratch."),
+		       *GetName());
+		return false;
+	}
+
+	ForceDirected::FLayoutBuffers& Positions = Solver.GetPositions();
+	for (int32 v = 0; v < static_cast<int32>(NumNodes); ++v)
+	{
+		Positions.Set(v, Cached.Get(CanonicalIndex[v]));
+	}
+	Solver.SetTemperature(WarmStartTemperature);
+
+	UE_LOG(LogTemp, Log, TEXT("AGraphUntangling::ApplyCachedLayout: Warm started %s from its cached layout (%d nodes)."),
+	       *GetName(), NumNodes);
+	return true;
+}
+
+void AGraphUntangling::StoreLayoutInCache()
+{
+	UArtGraphLayoutCache* LayoutCache = bUseLayoutCache && GEngine ? GEngine->GetEngineSubsystem<UArtGraphLayoutCache>() : nullptr;
+	if (!LayoutCache || NumNodes == 0)
+		return;
+
+	std::vector<int32_t> CanonicalIndex;
+	const uint64 Key = ComputeLayoutCacheKey(CanonicalIndex);
+	if (!Key)
 		return;
 
-	for (const TArray<AActor*>& NodeConnections : ActorAdjacencyList)
+	const ForceDirected::FLayoutBuffers& Positions = Solver.GetPositions();
+	ForceDirected::FLayoutBuffers Canonical;
+	Canonical.SetNumZeroed(static_cast<int32>(NumNodes));
+	for (int32 v = 0; v < static_cast<int32>(NumNodes); ++v)
+	{
+		Canonical.Set(CanonicalIndex[v], Positions.Get(v));
+	}
+	LayoutCache->StoreLayout(Key, Canonical);
+}
+
+void AGraphUntangling::WritePositionsToActors(const ForceDirected::FLayoutBuffers& Positions)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ArtGraph_WriteBack);
+
+	// Read once, so the loop below does no string work at all unless asked to
+	const bool bDebugMessages = CVarArtGraphDebugMessages.GetValueOnGameThread() && GEngine;
+
+	// Nodes that barely moved since they were last written are left alone, which keeps transform propagation,
+	// overlap updates and render state dirtying proportional to what actually moves
+	const float ThresholdSquared = FMath::Square(FMath::Max(WriteBackThreshold, 0.f));
+	const int32 NumWritable = FMath::Min3(Positions.Num(), NodeActors.Num(), LastWrittenPositions.Num());
+	int32 NumPushed = 0;
+
+	for (int32 v = 0; v < NumWritable; ++v)
 	{
-		if (NodeConnections.Num() < 2 || !NodeConnections[0])
+		const ForceDirected::FVec3 Position = Positions.Get(v);
+		const FVector3f NewLocation(Position.X, Position.Y, Position.Z);
+		const FVector3f Move = NewLocation - LastWrittenPositions[v];
+		if (Move.SizeSquared() <= ThresholdSquared)
 			continue;
 
-		const FVector Start = NodeConnections[0]->GetActorLocation();
+		// Positions computed before an external move must not undo it
+		if (!ExternallyMovedNodes.IsEmpty() && ExternallyMovedNodes.Contains(v))
+			continue;
 
-		for (int32 i = 1; i < NodeConnections.Num(); ++i)
-		{
-			const AActor* Neighbor = NodeConnections[i];
-			if (!Neighbor)
-				continue;
+		AActor* NodeActor = NodeActors[v];
+		if (!NodeActor)
+			continue;
 
-			const FVector End = Neighbor->GetActorLocation();
-			DrawDebugLine(World, Start, End, LineColor, PersistentLines, LineDuration, 0, LineThickness);
-		}
+		// The layout places nodes, it doesn't move them through the world
+		TGuardValue<bool> WritingGuard(bWritingPositions, true);
+		NodeActor->SetActorLocation(FVector(NewLocation), false, nullptr, ETeleportType::TeleportPhysics);
+		LastWrittenPositions[v] = NewLocation;
+		++NumPushed;
+
+		if (!bDebugMessages)
+			continue;
+
+		// Debug print for movement
+		GEngine->AddOnScreenDebugMessage(-1, 1.5f, FColor::Green,
+		                                 FString::Printf(TEXT("Move: %s | Δ: (%.2f, %.2f, %.2f) | Norm: %.2f"),
+		                                                 *NodeActor->GetName(), Move.X, Move.Y, Move.Z,
+		                                                 Move.Size()));
 	}
+
+	INC_DWORD_STAT_BY(STAT_ArtGraph_TransformsPushed, NumPushed);
+}
+
+void AGraphUntangling::StepSolver()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGraphUntangling::StepSolver);
+	Solver.Step();
+
+	// Stats and counters are global, so nothing is reported from here: several solvers may step at once
+	const ForceDirected::FStepTimings& Timings = Solver.GetLastStepTimings();
+	PendingStepTimings.Repulsion += Timings.Repulsion;
+	PendingStepTimings.Attraction += Timings.Attraction;
+	PendingStepTimings.Apply += Timings.Apply;
+}
+
+void AGraphUntangling::CaptureStepStats()
+{
+	CapturedStepStats.Timings = PendingStepTimings;
+	CapturedStepStats.Energy = Solver.GetEnergy();
+	CapturedStepStats.Temperature = Solver.GetTemperature();
+	CapturedStepStats.MaxDisplacement = Solver.GetMaxDisplacement();
+	CapturedStepStats.NumLayouts = 1;
+	bStepStatsCaptured = true;
+	PendingStepTimings = ForceDirected::FStepTimings();
+}
+
+bool AGraphUntangling::ConsumeStepStats(FGraphLayoutStepStats& Stats)
+{
+	if (!bStepStatsCaptured)
+		return false;
+
+	Stats.Timings.Repulsion += CapturedStepStats.Timings.Repulsion;
+	Stats.Timings.Attraction += CapturedStepStats.Timings.Attraction;
+	Stats.Timings.Apply += CapturedStepStats.Timings.Apply;
+	Stats.Energy += CapturedStepStats.Energy;
+	Stats.Temperature = FMath::Max(Stats.Temperature, CapturedStepStats.Temperature);
+	Stats.MaxDisplacement = FMath::Max(Stats.MaxDisplacement, CapturedStepStats.MaxDisplacement);
+	Stats.NumLayouts += CapturedStepStats.NumLayouts;
+	bStepStatsCaptured = false;
+	return true;
+}
+
+void AGraphUntangling::ReportStepStats(const FGraphLayoutStepStats& Stats)
+{
+	const double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle();
+	SET_CYCLE_COUNTER(STAT_ArtGraph_Repulsion, static_cast<uint32>(Stats.Timings.Repulsion / SecondsPerCycle));
+	SET_CYCLE_COUNTER(STAT_ArtGraph_Attraction, static_cast<uint32>(Stats.Timings.Attraction / SecondsPerCycle));
+	SET_CYCLE_COUNTER(STAT_ArtGraph_Apply, static_cast<uint32>(Stats.Timings.Apply / SecondsPerCycle));
+
+	SET_FLOAT_STAT(STAT_ArtGraph_Energy, Stats.Energy);
+	SET_FLOAT_STAT(STAT_ArtGraph_Temperature, Stats.Temperature);
+	SET_FLOAT_STAT(STAT_ArtGraph_MaxDisplacement, Stats.MaxDisplacement);
+	TRACE_COUNTER_SET(ArtGraph_Energy, Stats.Energy);
+	TRACE_COUNTER_SET(ArtGraph_Temperature, Stats.Temperature);
+	TRACE_COUNTER_SET(ArtGraph_MaxDisplacement, Stats.MaxDisplacement);
 }
 
 void AGraphUntangling::DoStep()
 {
-	// Gather current positions
-	for (int32 i = 0; i < NumNodes; ++i)
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGraphUntangling::DoStep);
+	if (NumNodes == 0)
+		return;
+
+	// The solver owns the positions, actors are only read to start from where they were placed
+	// and when something else moved them
+	SyncSolverWithActors();
+
+	Solver.SetSettings(MakeSolverSettings());
+	StepSolver();
+	CaptureStepStats();
+
+	// Apply to actors, which has to happen on the game thread
+	WritePositionsToActors(Solver.GetPositions());
+}
+
+int32 AGraphUntangling::AdvanceLayout(const float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGraphUntangling::AdvanceLayout);
+	const int32 NumDue = BeginLayoutStep(DeltaTime);
+	if (NumDue == 0)
+		return 0;
+
+	const int32 NumSteps = RunLayoutSteps(NumDue, TNumericLimits<double>::Max(), true);
+	EndLayoutStep(NumSteps);
+	return NumSteps;
+}
+
+bool AGraphUntangling::PrepareLayoutTick()
+{
+	// Pick up topology changes reported since the last tick, unless the graph rebuilt to the same adjacency
+	if (bGraphDirty)
 	{
-		if (const AActor* NodeActor = (ActorAdjacencyList[i].Num() > 0) ? ActorAdjacencyList[i][0] : nullptr)
+		if (IsTopologyUpToDate())
 		{
-			Positions[i] = NodeActor->GetActorLocation();
+			bGraphDirty = false;
 		}
 		else
 		{
-			Positions[i] = FVector::ZeroVector;
+			RefreshUntangleableActors();
 		}
 	}
 
-	// Repulsion between all pairs
-	for (int32 v = 0; v < NumNodes; ++v)
+	// Nothing matched, sleep until the graph or the actors change. Nothing was solved, so this isn't convergence.
+	if (NumNodes == 0)
 	{
-		for (int32 u = v + 1; u < NumNodes; ++u)
-		{
-			// No need to repulse self
-			if (v == u)
-				continue;
+		EnterIdleState();
+		return false;
+	}
+	return true;
+}
 
-			FVector Delta = Positions[v] - Positions[u];
-			const float Dist = Delta.Size();
+int32 AGraphUntangling::BeginLayoutStep(const float DeltaTime)
+{
+	if (NumNodes == 0)
+		return 0;
 
-			if (Dist < KINDA_SMALL_NUMBER)
-				continue;
+	// Take the solver back from the background task. Its positions carry over, but whatever it published
+	// last may not have been written yet.
+	WaitForAsyncSolve();
 
-			// Not worth computing if the distance is too large
-			if (Dist > 1000.f)
-				continue;
+	const double StepTime = 1.0 / FMath::Max(IterationsPerSecond, 1.f);
+	StepAccumulator = FMath::Min(StepAccumulator + DeltaTime, FMath::Max(GMax_Step_Backlog_Seconds, StepTime));
 
-			const float Repulsion = KSquared / Dist;
-			FVector Direction = Delta / Dist;
-			// Apply repulsion forces for both nodes
-			Movements[v] += Direction * Repulsion;
-			Movements[u] -= Direction * Repulsion;
+	// Faster frames than iterations, nothing due yet
+	if (StepAccumulator < StepTime)
+		return 0;
 
-			// Debug print for repulsion
-			const AActor* ActorV = (ActorAdjacencyList[v].Num() > 0) ? ActorAdjacencyList[v][0] : nullptr;
-			const AActor* ActorU = (ActorAdjacencyList[u].Num() > 0) ? ActorAdjacencyList[u][0] : nullptr;
-			if (ActorV && ActorU)
-			{
-				FString Msg = FString::Printf(TEXT("Repulsion: %s <-> %s | Dist: %.2f | Rep: %.2f"),
-				                              *ActorV->GetName(), *ActorU->GetName(), Dist, Repulsion);
-				if (GEngine)
-					GEngine->AddOnScreenDebugMessage(-1, 1.5f, FColor::Cyan, Msg);
-			}
-		}
+	SyncSolverWithActors();
+	return FMath::FloorToInt32(StepAccumulator / StepTime);
+}
+
+int32 AGraphUntangling::RunLayoutSteps(const int32 NumSteps, const double Deadline, const bool bSplitForces)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGraphUntangling::RunLayoutSteps);
+
+	// Out of shared budget before this layout got its turn
+	const double Start = FPlatformTime::Seconds();
+	if (NumSteps <= 0 || Start >= Deadline)
+		return 0;
+
+	ForceDirected::FSolverSettings Settings = MakeSolverSettings();
+	if (!bSplitForces)
+	{
+		Settings.NumTasks = 1;
 	}
+	Solver.SetSettings(Settings);
 
-	// Attraction along edges
-	for (int32 v = 0; v < NumNodes; ++v)
+	// Whatever doesn't fit stays in the accumulator and runs next frame
+	const double StepTime = 1.0 / FMath::Max(IterationsPerSecond, 1.f);
+	const double LayoutDeadline = FMath::Min(Deadline, Start + FMath::Max(FrameBudgetMs, 0.f) * 0.001);
+	int32 NumRun = 0;
+	do
 	{
-		const TArray<AActor*>& NodeList = ActorAdjacencyList[v];
-		AActor* NodeActor = (NodeList.Num() > 0) ? NodeList[0] : nullptr;
-		if (!NodeActor)
-			continue;
+		StepSolver();
+		StepAccumulator -= StepTime;
+		++NumRun;
+	}
+	while (NumRun < NumSteps && !Solver.IsConverged() && FPlatformTime::Seconds() < LayoutDeadline);
+	return NumRun;
+}
 
-		for (int32 n = 1; n < NodeList.Num(); ++n)
+void AGraphUntangling::EndLayoutStep(const int32 NumStepsRun)
+{
+	INC_DWORD_STAT_BY(STAT_ArtGraph_Iterations, NumStepsRun);
+
+	// Convergence is only known after an iteration ran, a pending reset hasn't been applied before that
+	if (NumStepsRun == 0)
+		return;
+
+	// Intermediate iterations are never seen, only write back where the last one ended up
+	WritePositionsToActors(Solver.GetPositions());
+	CaptureStepStats();
+	if (Solver.IsConverged())
+	{
+		EnterConvergedState();
+	}
+}
+
+void AGraphUntangling::WaitForAsyncSolve()
+{
+	if (AsyncSolveTask.IsValid())
+	{
+		AsyncSolveTask.Wait();
+		AsyncSolveTask = UE::Tasks::FTask();
+	}
+}
+
+void AGraphUntangling::ApplyLatestSnapshot()
+{
+	if (!AsyncSnapshots.Update())
+		return;
+
+	// Snapshots hold absolute positions, so skipped ones don't matter
+	WritePositionsToActors(AsyncSnapshots.GetReadBuffer().Positions);
+}
+
+void AGraphUntangling::TickAsync()
+{
+	if (NumNodes == 0)
+		return;
+
+	ApplyLatestSnapshot();
+
+	// Still busy with the previous batch; the actors keep showing the last finished iteration
+	if (AsyncSolveTask.IsValid() && !AsyncSolveTask.IsCompleted())
+		return;
+
+	// The finished batch no longer touches the solver, so its statistics can be read here
+	if (AsyncSolveTask.IsValid())
+	{
+		CaptureStepStats();
+	}
+
+	// Only seed the positions from the actors once, reading them back every batch would throw away iterations
+	// that were published but not applied yet
+	SyncSolverWithActors();
+
+	// The last batch settled the layout and its snapshot was applied above
+	if (Solver.IsConverged())
+	{
+		EnterConvergedState();
+		return;
+	}
+
+	// The task is idle, so settings can be changed without racing it
+	Solver.SetSettings(MakeSolverSettings());
+
+	const int32 NumIterations = FMath::Max(AsyncIterationsPerTask, 1);
+	AsyncSolveTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, NumIterations]
+	{
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
 		{
-			const AActor* NeighborActor = NodeList[n];
-			if (!NeighborActor)
-				continue;
+			StepSolver();
+		}
+		AsyncIteration += NumIterations;
+
+		ForceDirected::FLayoutSnapshot& Snapshot = AsyncSnapshots.GetWriteBuffer();
+		Snapshot.Positions = Solver.GetPositions();
+		Snapshot.Iteration = AsyncIteration;
+		Snapshot.Temperature = Solver.GetTemperature();
+		AsyncSnapshots.Publish();
+	});
+}
 
-			// Optimized: Use ActorToIndexMap instead of linear search
-			int32 NeighborIdx = INDEX_NONE;
-			if (const int32* FoundIdx = ActorToIndexMap.Find(NeighborActor))
-			{
-				NeighborIdx = *FoundIdx;
-			}
-			if (NeighborIdx == INDEX_NONE || NeighborIdx == v)
+void AGraphUntangling::SyncSolverWithActors()
+{
+	if (!bPositionsSeeded)
+	{
+		SeedPositions();
+	}
+	else
+	{
+		// Nodes dragged around by the user or by gameplay continue from where they were put
+		ForceDirected::FLayoutBuffers& Positions = Solver.GetPositions();
+		for (const int32 Node : ExternallyMovedNodes)
+		{
+			const AActor* NodeActor = NodeActors.IsValidIndex(Node) ? NodeActors[Node].Get() : nullptr;
+			if (!NodeActor || Node >= Positions.Num())
 				continue;
-			if (NeighborIdx > v)
-				continue; // Only process each edge once
 
-			FVector Delta = Positions[v] - Positions[NeighborIdx];
-			const float Distance = Delta.Size();
-			if (Distance < KINDA_SMALL_NUMBER)
-				continue;
+			const FVector3f Location(NodeActor->GetActorLocation());
+			Positions.Set(Node, ForceDirected::FVec3(Location.X, Location.Y, Location.Z));
+			LastWrittenPositions[Node] = Location;
+		}
+	}
+	ExternallyMovedNodes.Empty();
 
-			const float Attraction = (Distance * Distance) / KConstant;
-			FVector Dir = Delta / Distance;
-			// Apply attraction forces for both nodes
-			Movements[v] -= Dir * Attraction;
-			Movements[NeighborIdx] += Dir * Attraction;
+	if (bConvergenceResetPending)
+	{
+		Solver.ResetConvergence();
+		bConvergenceResetPending = false;
+	}
+}
 
-			// Debug print for attraction
-			const AActor* ActorV = NodeActor;
-			const AActor* ActorN = NeighborActor;
-			if (ActorV && ActorN)
-			{
-				FString Msg = FString::Printf(TEXT("Attraction: %s <-> %s | Dist: %.2f | Attr: %.2f"),
-				                              *ActorV->GetName(), *ActorN->GetName(), Distance, Attraction);
-				if (GEngine)
-					GEngine->AddOnScreenDebugMessage(-1, 1.5f, FColor::Orange, Msg);
-			}
-		}
+void AGraphUntangling::EnterConvergedState()
+{
+	bLayoutConverged = true;
+	SetActorTickEnabled(false);
+	StoreLayoutInCache();
+
+	UE_LOG(LogTemp, Log,
+	       TEXT("AGraphUntangling::EnterConvergedState: %s settled (max drift %.3f, energy %.3f). Sleeping until something changes."),
+	       *GetName(), Solver.GetMaxDrift(), Solver.GetEnergy());
+	OnLayoutConverged.Broadcast(this);
+}
+
+void AGraphUntangling::EnterIdleState()
+{
+	bLayoutIdle = true;
+	SetActorTickEnabled(false);
+}
+
+void AGraphUntangling::WakeLayout()
+{
+	bConvergenceResetPending = true;
+	if (IsLayoutSleeping())
+	{
+		bLayoutConverged = false;
+		bLayoutIdle = false;
+		StepAccumulator = 0.0;
+		SetActorTickEnabled(!LayoutSubsystem.IsValid());
 	}
+}
 
-	// Cap movement by temperature and apply to actors
-	for (int32 v = 0; v < NumNodes; ++v)
+void AGraphUntangling::RequestTargetedGraph()
+{
+	// Already in memory, loaded by us or by whatever else references it
+	LoadedGraph = TargetedGraph.Get();
+	if (LoadedGraph || TargetedGraph.IsNull())
+		return;
+
+	if (TargetedGraphLoadHandle.IsValid() && TargetedGraphLoadHandle->IsLoadingInProgress())
+		return;
+
+	// The editor refreshes the layout on demand and expects the graph to be there when it returns
+	const UWorld* World = GetWorld();
+	UArtGraphSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UArtGraphSubsystem>() : nullptr;
+	if (!Subsystem || !World || !World->IsGameWorld())
 	{
-		const float MoveNorm = Movements[v].Size();
-		// < 1.0: No need to cap movements for those that are already moving very little
-		if (MoveNorm < 1.f)
+		LoadedGraph = TargetedGraph.LoadSynchronous();
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("AGraphUntangling::RequestTargetedGraph: Loading %s."), *TargetedGraph.ToString());
+	TargetedGraphLoadHandle = Subsystem->RequestGraphAsync(
+		TargetedGraph.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &AGraphUntangling::OnTargetedGraphLoaded));
+}
+
+void AGraphUntangling::SetTargetedGraph(UGraphElement* Graph)
+{
+	if (TargetedGraph.Get() == Graph && LoadedGraph == Graph)
+		return;
+
+	// Whatever was still loading for the previous graph isn't needed anymore
+	if (TargetedGraphLoadHandle.IsValid())
+	{
+		TargetedGraphLoadHandle->CancelHandle();
+		TargetedGraphLoadHandle.Reset();
+	}
+
+	TargetedGraph = Graph;
+	LoadedGraph = Graph;
+	bGraphDirty = true;
+	WakeLayout();
+}
+
+void AGraphUntangling::OnTargetedGraphLoaded()
+{
+	TargetedGraphLoadHandle.Reset();
+	LoadedGraph = TargetedGraph.Get();
+	if (!LoadedGraph)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AGraphUntangling::OnTargetedGraphLoaded: Failed to load %s."),
+		       *TargetedGraph.ToString());
+		return;
+	}
+
+	bGraphDirty = true;
+	WakeLayout();
+}
+
+void AGraphUntangling::BindTargetedGraph()
+{
+	UGraphElement* Graph = TargetedGraph.Get();
+	if (BoundGraph.Get() == Graph)
+		return;
+
+	UnbindTargetedGraph();
+	if (Graph)
+	{
+		GraphChangedHandle = Graph->OnAdjacencyListChanged.AddUObject(
+			this, &AGraphUntangling::OnTargetedGraphChanged);
+		BoundGraph = Graph;
+	}
+}
+
+void AGraphUntangling::UnbindTargetedGraph()
+{
+	if (UGraphElement* Graph = BoundGraph.Get())
+	{
+		Graph->OnAdjacencyListChanged.Remove(GraphChangedHandle);
+	}
+	GraphChangedHandle.Reset();
+	BoundGraph.Reset();
+}
+
+void AGraphUntangling::BindNodeActors()
+{
+	for (int32 v = 0; v < NodeActors.Num(); ++v)
+	{
+		AActor* NodeActor = NodeActors[v];
+		if (!NodeActor)
 			continue;
-		const float CappedNorm = FMath::Min(MoveNorm, Temperature);
-		FVector CappedMove = Movements[v] / MoveNorm * CappedNorm;
 
-		if (AActor* NodeActor = (ActorAdjacencyList[v].Num() > 0) ? ActorAdjacencyList[v][0] : nullptr)
+		if (USceneComponent* Root = NodeActor->GetRootComponent())
 		{
-			NodeActor->SetActorLocation(NodeActor->GetActorLocation() + CappedMove);
+			Root->TransformUpdated.AddUObject(this, &AGraphUntangling::OnNodeTransformUpdated, v);
+		}
+	}
+}
+
+void AGraphUntangling::UnbindNodeActors()
+{
+	for (AActor* NodeActor : NodeActors)
+	{
+		if (!NodeActor)
+			continue;
 
-			// Debug print for movement
-			FString Msg = FString::Printf(TEXT("Move: %s | Δ: (%.2f, %.2f, %.2f) | Norm: %.2f"),
-			                              *NodeActor->GetName(), CappedMove.X, CappedMove.Y, CappedMove.Z, CappedNorm);
-			if (GEngine)
-				GEngine->AddOnScreenDebugMessage(-1, 1.5f, FColor::Green, Msg);
+		if (USceneComponent* Root = NodeActor->GetRootComponent())
+		{
+			Root->TransformUpdated.RemoveAll(this);
 		}
 	}
+}
+
+bool AGraphUntangling::IsTopologyUpToDate()
+{
+	UGraphElement* Graph = TargetedGraph.Get();
+	if (bNodeActorsDirty || !Graph || BoundGraph.Get() != Graph)
+		return false;
+
+	return Graph->GetAdjacencyView().Generation == BuiltGraphGeneration;
+}
+
+void AGraphUntangling::OnTargetedGraphChanged(UGraphElement* Graph)
+{
+	bGraphDirty = true;
+	WakeLayout();
+}
+
+void AGraphUntangling::OnUntangleableRegistered(AActor* Actor, const FGameplayTagContainer& Tags)
+{
+	// Only an actor standing in for a node that has none yet changes the graph
+	if (bNodeActorsDirty || UnresolvedNodeTags.IsEmpty() || !Tags.HasAll(SecondaryTags))
+		return;
 
-	// Cool down fast until we reach 1.5, then stay at low temperature
-	if (Temperature > 1.5f)
+	for (const FGameplayTag& Tag : Tags.GetGameplayTagParents())
 	{
-		Temperature *= 0.85f;
+		if (UnresolvedNodeTags.Contains(Tag))
+		{
+			bGraphDirty = true;
+			bNodeActorsDirty = true;
+			WakeLayout();
+			return;
+		}
 	}
-	else
+}
+
+void AGraphUntangling::OnUntangleableUnregistered(AActor* Actor, const FGameplayTagContainer& Tags)
+{
+	if (!bNodeActorsDirty && NodeActors.Contains(Actor))
 	{
-		Temperature = 1.5f;
+		bGraphDirty = true;
+		bNodeActorsDirty = true;
+		WakeLayout();
 	}
+}
+
+void AGraphUntangling::OnNodeTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags,
+                                              ETeleportType Teleport, const int32 Node)
+{
+	// Every move ends up here, including the layout's own write-backs
+	EdgeRenderer->SetNodePosition(Node, FVector3f(Component->GetComponentLocation()));
 
-	// // Log the current temperature
-	// UE_LOG(LogTemp, Log, TEXT("Current Temperature: %.2f"), Temperature);
+	if (bWritingPositions)
+		return;
+
+	ExternallyMovedNodes.Add(Node);
+	WakeLayout();
 }
 
 void AGraphUntangling::Tick(const float DeltaTime)
 {
 	Super::Tick(DeltaTime);
-	DoStep();
-	DrawAdjacencyLines(3.0f, false, 0.0f);
+	TickLayout(DeltaTime);
+}
+
+void AGraphUntangling::TickLayout(const float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGraphUntangling::TickLayout);
+	if (!PrepareLayoutTick())
+		return;
+
+	if (bSolveAsynchronously)
+	{
+		TickAsync();
+	}
+	else
+	{
+		AdvanceLayout(DeltaTime);
+	}
+
+	// Combined over every layout by the subsystem when there is one
+	FGraphLayoutStepStats Stats;
+	if (!LayoutSubsystem.IsValid() && ConsumeStepStats(Stats))
+	{
+		ReportStepStats(Stats);
+	}
 }
 
 // void AGraphUntangling::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
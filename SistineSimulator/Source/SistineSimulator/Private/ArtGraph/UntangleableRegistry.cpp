@@ -0,0 +1,204 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ArtGraph/UntangleableRegistry.h"
+#include "ArtGraph/Untangleable.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+
+void UUntangleableRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UWorld* World = GetWorld())
+	{
+		ActorSpawnedHandle = World->AddOnActorSpawnedHandler(
+			FOnActorSpawned::FDelegate::CreateUObject(this, &UUntangleableRegistry::HandleActorSpawned));
+	}
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UUntangleableRegistry::HandleLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(
+		this, &UUntangleableRegistry::HandleLevelRemoved);
+}
+
+void UUntangleableRegistry::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	RegisteredActors.Empty();
+	TagToActors.Empty();
+	bPopulated = false;
+
+	Super::Deinitialize();
+}
+
+void UUntangleableRegistry::RegisterActor(AActor* Actor)
+{
+	if (!IsValid(Actor) || !Actor->GetClass()->ImplementsInterface(UUntangleable::StaticClass()))
+		return;
+
+	if (RegisteredActors.Contains(Actor))
+		return;
+
+	// The only Blueprint call per actor
+	const FGameplayTagContainer Tags = IUntangleable::Execute_GetTags(Actor);
+	RegisteredActors.Add(Actor, Tags);
+	AddToIndex(Actor, Tags);
+
+	Actor->OnEndPlay.AddUniqueDynamic(this, &UUntangleableRegistry::HandleActorEndPlay);
+	Actor->OnDestroyed.AddUniqueDynamic(this, &UUntangleableRegistry::HandleActorDestroyed);
+
+	OnActorRegistered.Broadcast(Actor, Tags);
+}
+
+void UUntangleableRegistry::UnregisterActor(AActor* Actor)
+{
+	FGameplayTagContainer Tags;
+	if (!Actor || !RegisteredActors.RemoveAndCopyValue(Actor, Tags))
+		return;
+
+	RemoveFromIndex(Actor, Tags);
+	Actor->OnEndPlay.RemoveDynamic(this, &UUntangleableRegistry::HandleActorEndPlay);
+	Actor->OnDestroyed.RemoveDynamic(this, &UUntangleableRegistry::HandleActorDestroyed);
+
+	OnActorUnregistered.Broadcast(Actor, Tags);
+}
+
+void UUntangleableRegistry::UpdateActorTags(AActor* Actor)
+{
+	// Listeners see the actor leave with its old tags and come back with the new ones
+	UnregisterActor(Actor);
+	RegisterActor(Actor);
+}
+
+AActor* UUntangleableRegistry::FindActor(const FGameplayTag& Tag, const FGameplayTagContainer& RequiredTags)
+{
+	EnsurePopulated();
+
+	const TArray<TWeakObjectPtr<AActor>>* Candidates = TagToActors.Find(Tag);
+	if (!Candidates)
+		return nullptr;
+
+	for (const TWeakObjectPtr<AActor>& Candidate : *Candidates)
+	{
+		AActor* Actor = Candidate.Get();
+		if (!Actor)
+			continue;
+
+		const FGameplayTagContainer* Tags = RegisteredActors.Find(Actor);
+		if (Tags && Tags->HasAll(RequiredTags))
+			return Actor;
+	}
+	return nullptr;
+}
+
+const FGameplayTagContainer* UUntangleableRegistry::GetActorTags(const AActor* Actor) const
+{
+	return RegisteredActors.Find(Actor);
+}
+
+void UUntangleableRegistry::EnsurePopulated()
+{
+	if (bPopulated)
+		return;
+	bPopulated = true;
+
+	if (const UWorld* World = GetWorld())
+	{
+		for (const ULevel* Level : World->GetLevels())
+		{
+			AddLevelActors(Level);
+		}
+	}
+	UE_LOG(LogTemp, Log, TEXT("UUntangleableRegistry::EnsurePopulated: Indexed %d untangleable actors in %s."),
+	       RegisteredActors.Num(), *GetNameSafe(GetWorld()));
+}
+
+void UUntangleableRegistry::AddLevelActors(const ULevel* Level)
+{
+	if (!Level)
+		return;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		RegisterActor(Actor);
+	}
+}
+
+void UUntangleableRegistry::RemoveLevelActors(const ULevel* Level)
+{
+	if (!Level)
+		return;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		UnregisterActor(Actor);
+	}
+}
+
+void UUntangleableRegistry::AddToIndex(AActor* Actor, const FGameplayTagContainer& Tags)
+{
+	// Parents are indexed too, so looking up a tag finds actors carrying its children like HasAll does
+	for (const FGameplayTag& Tag : Tags.GetGameplayTagParents())
+	{
+		TagToActors.FindOrAdd(Tag).Add(Actor);
+	}
+}
+
+void UUntangleableRegistry::RemoveFromIndex(const AActor* Actor, const FGameplayTagContainer& Tags)
+{
+	for (const FGameplayTag& Tag : Tags.GetGameplayTagParents())
+	{
+		TArray<TWeakObjectPtr<AActor>>* Actors = TagToActors.Find(Tag);
+		if (!Actors)
+			continue;
+
+		// Keep the registration order, the first matching actor wins lookups
+		Actors->RemoveAll([Actor](const TWeakObjectPtr<AActor>& Entry)
+		{
+			return !Entry.IsValid() || Entry.Get() == Actor;
+		});
+		if (Actors->IsEmpty())
+		{
+			TagToActors.Remove(Tag);
+		}
+	}
+}
+
+void UUntangleableRegistry::HandleActorSpawned(AActor* Actor)
+{
+	// Before the first query the initial scan picks everything up anyway
+	if (bPopulated)
+	{
+		RegisterActor(Actor);
+	}
+}
+
+void UUntangleableRegistry::HandleLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (bPopulated && World == GetWorld())
+	{
+		AddLevelActors(Level);
+	}
+}
+
+void UUntangleableRegistry::HandleLevelRemoved(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld())
+	{
+		RemoveLevelActors(Level);
+	}
+}
+
+void UUntangleableRegistry::HandleActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterActor(Actor);
+}
+
+void UUntangleableRegistry::HandleActorDestroyed(AActor* Actor)
+{
+	UnregisterActor(Actor);
+}
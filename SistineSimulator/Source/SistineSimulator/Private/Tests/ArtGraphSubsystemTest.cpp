@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ArtGraph/ArtGraph.h"
+#include "ArtGraph/ArtGraphSubsystem.h"
+#include "Engine/Engine.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	UGraphElement* NewTestElement(const TCHAR* Name)
+	{
+		UPackage* Package = GetTransientPackage();
+		return NewObject<UGraphElement>(Package, MakeUniqueObjectName(Package, UGraphElement::StaticClass(), Name));
+	}
+
+	void SetEdges(UGraphElement* Graph, const TArray<TPair<UGraphElement*, UGraphElement*>>& Edges)
+	{
+		Graph->Edges.Reset();
+		for (const TPair<UGraphElement*, UGraphElement*>& Edge : Edges)
+		{
+			FGraphEdge& GraphEdge = Graph->Edges.AddDefaulted_GetRef();
+			GraphEdge.ElementA = Edge.Key;
+			GraphEdge.ElementB = Edge.Value;
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FArtGraphSubsystemConsistencyTest, "SistineSimulator.ArtGraph.Subsystem.Consistency",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FArtGraphSubsystemConsistencyTest::RunTest(const FString& Parameters)
+{
+	UArtGraphSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UArtGraphSubsystem>() : nullptr;
+	if (!TestNotNull(TEXT("ArtGraph subsystem"), Subsystem))
+		return false;
+
+	auto TestConsistent = [this, Subsystem](const TCHAR* What)
+	{
+		TArray<FString> Errors;
+		TestTrue(FString::Printf(TEXT("Maps are consistent %s"), What), Subsystem->CheckConsistency(&Errors));
+		for (const FString& Error : Errors)
+		{
+			AddError(Error);
+		}
+	};
+
+	// Two graphs over three elements, the outer one also referencing the inner graph
+	UGraphElement* A = NewTestElement(TEXT("ConsistencyA"));
+	UGraphElement* B = NewTestElement(TEXT("ConsistencyB"));
+	UGraphElement* C = NewTestElement(TEXT("ConsistencyC"));
+	UGraphElement* Inner = NewTestElement(TEXT("ConsistencyInner"));
+	UGraphElement* Outer = NewTestElement(TEXT("ConsistencyOuter"));
+	SetEdges(Inner, {{A, B}, {B, C}});
+	SetEdges(Outer, {{Inner, C}});
+
+	Subsystem->RegisterGraph(Inner);
+	Subsystem->RegisterGraph(Outer);
+	TestConsistent(TEXT("after registering"));
+
+	// Changing the inner graph's references goes through the queue and only dirties the outer graph
+	Outer->GetAdjacencyView();
+	SetEdges(Inner, {{A, C}});
+	Subsystem->BeginChangeBatch();
+	Subsystem->QueueElementChanged(Inner);
+	Subsystem->EndChangeBatch();
+	TestConsistent(TEXT("after a flushed change"));
+	TestTrue(TEXT("Dependent graph is dirty after the flush"), Outer->IsAdjacencyListDirty());
+
+	// Re-registering without clearing only adds references
+	SetEdges(Inner, {{A, C}, {B, C}});
+	Subsystem->RegisterGraph(Inner, false);
+	TestConsistent(TEXT("after re-registering without clearing"));
+
+	Subsystem->UnregisterGraph(Outer);
+	TestConsistent(TEXT("after unregistering a graph"));
+
+	// Elements go away once nothing references them anymore, as they would when destroyed
+	Subsystem->UnregisterGraph(Inner);
+	for (UGraphElement* Element : TArray<UGraphElement*>{A, B, C, Inner, Outer})
+	{
+		Subsystem->UnregisterElement(Element);
+	}
+	TestConsistent(TEXT("after unregistering every element"));
+
+	return true;
+}
+
+#endif
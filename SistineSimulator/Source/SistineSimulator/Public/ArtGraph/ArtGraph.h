@@ -7,6 +7,8 @@
 
 class UGraphElement;
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAdjacencyListChanged, UGraphElement*);
+
 /**
  * A struct representing an edge in a graph, connecting two graph elements.
  * This is used to represent the connections between different elements in the art graph.
@@ -23,6 +25,27 @@ struct SISTINESIMULATOR_API FGraphEdge
 	TObjectPtr<UGraphElement> ElementB;
 };
 
+/**
+ * Read-only view of a graph element's adjacency, borrowed from the element and valid until it is rebuilt.
+ * Node i has the tag NodeTags[i]; its sorted neighbor IDs are Neighbors[Offsets[i] .. Offsets[i + 1]).
+ */
+struct FGraphAdjacencyView
+{
+	TConstArrayView<FGameplayTag> NodeTags;
+	TConstArrayView<int32> Offsets;
+	TConstArrayView<int32> Neighbors;
+
+	// Generation of the adjacency this view was taken from
+	uint32 Generation = 0;
+
+	int32 Num() const { return NodeTags.Num(); }
+
+	TConstArrayView<int32> GetNeighbors(const int32 Node) const
+	{
+		return Neighbors.Slice(Offsets[Node], Offsets[Node + 1] - Offsets[Node]);
+	}
+};
+
 /**
  * A data asset representing a graph element in the art graph.
  * This class contains a tag and a list of edges within the graph.
@@ -41,32 +64,80 @@ public:
 		meta = (ToolTip = "The edges this graph element contains."))
 	TArray<FGraphEdge> Edges;
 
-	// Get the cached adjacency list
-	TArray<TArray<FGameplayTag>> GetAdjacencyList() const;
+	// Get a view of the adjacency, recomputing it first if it is dirty.
+	// Dirty graphs this one references are recomputed before it, each at most once.
+	FGraphAdjacencyView GetAdjacencyView();
 
-	// Helper function to update the cached adjacency list
-	// TODO: call this once on PostLoad?
+	// Get the adjacency as one tag list per node, the node itself first. Expanded from the view once per
+	// generation; prefer GetAdjacencyView, which copies nothing.
+	const TArray<TArray<FGameplayTag>>& GetAdjacencyList();
+
+	// Incremented whenever a rebuild actually changes the adjacency. Consumers that remember it can skip
+	// their own work when it is unchanged. Does not rebuild a dirty list.
+	uint32 GetAdjacencyGeneration() const { return AdjacencyGeneration; }
+
+	// Helper function to update the cached adjacency list right away
 	void UpdateAdjacencyList();
 
+	// Flag the cached adjacency list for recomputation on the next GetAdjacencyList call
+	void MarkAdjacencyListDirty();
+
+	bool IsAdjacencyListDirty() const { return bAdjacencyListDirty; }
+
 	// Get all elements referenced by this graph
 	TArray<UGraphElement*> GetReferencedElements() const;
 
+	// Broadcast when the adjacency list became dirty or was recalculated
+	FOnAdjacencyListChanged OnAdjacencyListChanged;
+
+	// Asset registry tag listing the object paths of the referenced elements, comma separated
+	static const FName ReferencedElementsTag;
+
+	virtual void GetAssetRegistryTags(FAssetRegistryTagsContext Context) const override;
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+	virtual void PostLoad() override;
+	virtual void BeginDestroy() override;
+
 protected:
 	// Override PostEditChangeProperty to update the adjacency list when properties change
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 
 private:
-	// Cache for the adjacency list
+	// Nested copy of the adjacency for GetAdjacencyList, expanded on demand
 	TArray<TArray<FGameplayTag>> CachedAdjacencyList;
+	uint32 CachedAdjacencyListGeneration = 0;
+
+	uint32 AdjacencyGeneration = 0;
+
+	// Graph-local node IDs: the tag of every node, in lexical tag order. Baked into the asset on save.
+	UPROPERTY()
+	TArray<FGameplayTag> NodeTags;
+
+	// Sorted neighbor IDs of node i are AdjacencyNeighbors[AdjacencyOffsets[i] .. AdjacencyOffsets[i + 1])
+	UPROPERTY()
+	TArray<int32> AdjacencyOffsets;
+
+	UPROPERTY()
+	TArray<int32> AdjacencyNeighbors;
+
+	// Whether the adjacency above was computed when the asset was saved
+	UPROPERTY()
+	bool bHasBakedAdjacency = false;
+
+	// Whether CachedAdjacencyList has to be recomputed before it is handed out
+	bool bAdjacencyListDirty = true;
 
 	// Debug property to display the cached adjacency list in the editor
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Debug",
 		meta = (AllowPrivateAccess = "true", MultiLine = true))
 	FString DebugAdjacencyList;
 
-	// Helper function to calculate the adjacency list and store it in CachedAdjacencyList
-	void CalculateAdjacencyList();
+	// Recompute the adjacency from integer tag IDs, returning whether it differs from the previous one
+	bool CalculateAdjacencyList();
+
+	// Rebuild the adjacency if it is dirty, through the subsystem when there is one
+	void EnsureAdjacencyListUpToDate();
 
-	// Helper function to format the DebugAdjacencyList string based on CachedAdjacencyList
+	// Helper function to format the DebugAdjacencyList string from the adjacency
 	void FormatDebugAdjacencyList();
 };
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Layout/LayoutCache.h"
+#include "ArtGraphLayoutCache.generated.h"
+
+class IConsoleObject;
+
+/**
+ * Settled graph layouts kept across sessions in Saved/ArtGraph/LayoutCache.bin.
+ *
+ * Entries are keyed by a hash of everything a layout depends on, computed by the untangler. The file is read
+ * on first use and written back when a world is cleaned up or the engine shuts down, if anything changed.
+ * Past ArtGraph.LayoutCacheMaxMB the least recently used layouts are dropped.
+ */
+UCLASS()
+class SISTINESIMULATOR_API UArtGraphLayoutCache : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Positions stored for Key if they were saved for NumNodes nodes
+	bool FindLayout(uint64 Key, int32 NumNodes, ForceDirected::FLayoutBuffers& OutPositions);
+
+	void StoreLayout(uint64 Key, const ForceDirected::FLayoutBuffers& Positions);
+
+	// Drop every entry, in memory and on disk
+	void Clear();
+
+	// Write the cache file now if anything changed since it was read
+	void SaveIfDirty();
+
+	static FString GetCacheFilePath();
+
+private:
+	ForceDirected::FLayoutCache Cache;
+
+	bool bLoaded = false;
+	bool bDirty = false;
+
+	FDelegateHandle WorldCleanupHandle;
+
+	// Console command running Clear
+	IConsoleObject* ClearCommand = nullptr;
+
+	void EnsureLoaded();
+
+	// ArtGraph.LayoutCacheMaxMB in bytes
+	static size_t GetMaxBytes();
+};
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ArtGraphLayoutSubsystem.generated.h"
+
+class AGraphUntangling;
+
+/**
+ * Steps every AGraphUntangling in a world once per frame, instead of each actor ticking on its own.
+ *
+ * The game thread prepares all layouts, their due iterations then run in one parallel dispatch per LayoutPriority,
+ * highest first, one task per layout, and the resulting positions are written back in one pass afterwards.
+ * Each layout stays within its own FrameBudgetMs, and all of them together within ArtGraph.LayoutBudgetMs.
+ * Layouts of the same priority share what is left of that budget when their dispatch starts; once it is used up
+ * the remaining priorities don't run and keep their iterations for the next frame.
+ * Asynchronous layouts are only given their game thread tick here, their solver runs on its own task.
+ * Solver statistics are combined over all layouts at the end of the frame, see FGraphLayoutStepStats.
+ */
+UCLASS()
+class SISTINESIMULATOR_API UArtGraphLayoutSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterLayout(AGraphUntangling* Layout);
+	void UnregisterLayout(AGraphUntangling* Layout);
+
+	int32 GetNumLayouts() const { return Layouts.Num(); }
+
+private:
+	// Combine the solver statistics of every layout stepped this frame and publish them once
+	void ReportStepStats();
+
+	struct FPendingLayoutStep
+	{
+		TObjectPtr<AGraphUntangling> Layout = nullptr;
+		int32 Priority = 0;
+		int32 NumDue = 0;
+		int32 NumRun = 0;
+	};
+
+	// Registered layouts, sorted by descending priority every Tick
+	TArray<TWeakObjectPtr<AGraphUntangling>> Layouts;
+
+	// Layouts with iterations due this frame in descending priority, reused across frames
+	TArray<FPendingLayoutStep> PendingSteps;
+};
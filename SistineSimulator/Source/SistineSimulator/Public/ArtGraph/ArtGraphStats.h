@@ -0,0 +1,8 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Stats/Stats.h"
+
+// Layout and rendering of art graphs, see "stat ArtGraph"
+DECLARE_STATS_GROUP(TEXT("ArtGraph"), STATGROUP_ArtGraph, STATCAT_Advanced);
@@ -3,10 +3,40 @@
 #include "CoreMinimal.h"
 #include "Subsystems/EngineSubsystem.h"
 #include "GameplayTagContainer.h"
+#include "Engine/StreamableManager.h"
 #include "ArtGraphSubsystem.generated.h"
 
 class UGraphElement;
 class UArtGraph;
+class IConsoleObject;
+struct FAssetData;
+
+/**
+ * What a single flush of queued element changes did.
+ */
+USTRUCT(BlueprintType)
+struct SISTINESIMULATOR_API FArtGraphFlushStats
+{
+	GENERATED_BODY()
+
+	// Elements whose changes were processed
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ArtGraph")
+	int32 NumChangedElements = 0;
+
+	// Graphs marked dirty because something they reference changed
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ArtGraph")
+	int32 NumDirtiedGraphs = 0;
+
+	// Adjacency lists recomputed since the previous flush. Flushes only mark graphs dirty, they are rebuilt when
+	// they are next read.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ArtGraph")
+	int32 NumRebuilds = 0;
+
+	// Graph assets referencing the changed elements, directly or not, that aren't loaded. Their baked
+	// adjacency is checked again when they are next loaded.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ArtGraph")
+	int32 NumUnloadedDependentGraphs = 0;
+};
 
 /**
  * A subsystem to manage and notify graphs when their elements change.
@@ -22,15 +52,116 @@ public:
 	// @param bClearPreviousReferences If true, unregister the graph from any elements it previously referenced before registering new ones.
 	void RegisterGraph(UGraphElement *Graph, bool bClearPreviousReferences = true);
 
-	// Unregister a graph from the subsystem
+	// Unregister a graph from the subsystem, touching only the elements it referenced
 	void UnregisterGraph(UGraphElement *Graph);
 
-	// Notify graphs that reference the given element to update their caches
+	// Drop an element that is being destroyed from the subsystem entirely
+	void UnregisterElement(UGraphElement *Element);
+
+	// Object paths of the graph assets referencing the element at ElementPath, loaded or not, as indexed
+	// from the asset registry. With bTransitive, graphs referencing those graphs are included as well.
+	TArray<FSoftObjectPath> GetDependentGraphPaths(const FSoftObjectPath &ElementPath, bool bTransitive = false) const;
+
+	// Load a graph asset through the streamable manager. OnLoaded runs once it and everything it references
+	// is in memory, immediately if it already is.
+	TSharedPtr<FStreamableHandle> RequestGraphAsync(const FSoftObjectPath &GraphPath,
+	                                                FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+	// Mark every graph that references the given element, directly or through other graphs, dirty.
+	// Nothing is recomputed here; each dirty graph rebuilds once when its adjacency list is next read.
 	void NotifyElementChanged(UGraphElement *ChangedElement);
 
+	// Queue an edited element. Queued elements are re-registered and their dependents marked dirty, either when
+	// the outermost batch ends or at the end of the frame. Every affected graph rebuilds once when next read.
+	void QueueElementChanged(UGraphElement *ChangedElement);
+
+	// Open a change batch; nothing queued is processed until the matching EndChangeBatch. Batches nest.
+	UFUNCTION(BlueprintCallable, Category = "ArtGraph")
+	void BeginChangeBatch();
+
+	// Close a change batch, flushing the queued changes when it was the outermost one
+	UFUNCTION(BlueprintCallable, Category = "ArtGraph")
+	void EndChangeBatch();
+
+	UFUNCTION(BlueprintPure, Category = "ArtGraph")
+	bool IsInChangeBatch() const { return BatchDepth > 0; }
+
+	// Process every queued change now, regardless of open batches
+	UFUNCTION(BlueprintCallable, Category = "ArtGraph")
+	FArtGraphFlushStats FlushPendingChanges();
+
+	// What the most recent flush did
+	UFUNCTION(BlueprintPure, Category = "ArtGraph")
+	FArtGraphFlushStats GetLastFlushStats() const { return LastFlushStats; }
+
+	// Adjacency lists recomputed through RebuildAdjacencyList since the subsystem started
+	UFUNCTION(BlueprintPure, Category = "ArtGraph")
+	int32 GetNumAdjacencyListRebuilds() const { return NumAdjacencyListRebuilds; }
+
+	// Recompute Graph's adjacency list if it is dirty, after every dirty graph it references, so each graph
+	// is rebuilt at most once and in dependency order. Reference cycles are reported and broken.
+	void RebuildAdjacencyList(UGraphElement *Graph);
+
+	// Verify that ElementToDependentGraphsMap and GraphToReferencedElementsMap mirror each other exactly.
+	// Problems are logged and, if OutErrors is given, appended to it. Returns true if the maps are consistent.
+	bool CheckConsistency(TArray<FString> *OutErrors = nullptr) const;
+
 	virtual void Initialize(FSubsystemCollectionBase &Collection) override;
+	virtual void Deinitialize() override;
 
 private:
 	// Map of elements to the graphs that reference them
 	TMap<UGraphElement *, TSet<UGraphElement *>> ElementToDependentGraphsMap;
+
+	// Reverse of ElementToDependentGraphsMap: graphs to the elements they were registered with
+	TMap<UGraphElement *, TSet<UGraphElement *>> GraphToReferencedElementsMap;
+
+	// Object paths of the referenced elements of every graph asset, read from asset registry tags or
+	// updated when a loaded graph registers. Covers assets that were never loaded.
+	TMap<FSoftObjectPath, TSet<FSoftObjectPath>> GraphPathToReferencedPathsMap;
+
+	// Reverse of GraphPathToReferencedPathsMap
+	TMap<FSoftObjectPath, TSet<FSoftObjectPath>> ElementPathToDependentGraphPathsMap;
+
+	// Console command running CheckConsistency
+	IConsoleObject *CheckConsistencyCommand = nullptr;
+
+	// Edited elements waiting for the next flush
+	TSet<TWeakObjectPtr<UGraphElement>> PendingChangedElements;
+
+	int32 BatchDepth = 0;
+	int32 NumAdjacencyListRebuilds = 0;
+	int32 RebuildsAtLastFlush = 0;
+	FArtGraphFlushStats LastFlushStats;
+
+	FDelegateHandle EndFrameHandle;
+
+	// Mark all transitive dependents of the changed elements dirty, each once
+	void MarkDependentsDirty(TConstArrayView<UGraphElement *> ChangedElements, TSet<UGraphElement *> &OutDirtiedGraphs);
+
+	void HandleEndFrame();
+
+	void SetReferencedPaths(const FSoftObjectPath &GraphPath, TSet<FSoftObjectPath> &&ReferencedPaths);
+	void RemoveReferencedPaths(const FSoftObjectPath &GraphPath);
+
+	// Index every graph asset known to the asset registry from its tags
+	void IndexGraphAssets();
+	void HandleAssetRemoved(const FAssetData &AssetData);
+	void HandleAssetRenamed(const FAssetData &AssetData, const FString &OldObjectPath);
+};
+
+/**
+ * Keeps a change batch open on the ArtGraph subsystem for the lifetime of the scope, so bulk edits are
+ * processed once when it closes.
+ */
+class SISTINESIMULATOR_API FScopedArtGraphChangeBatch
+{
+public:
+	FScopedArtGraphChangeBatch();
+	~FScopedArtGraphChangeBatch();
+
+	UE_NONCOPYABLE(FScopedArtGraphChangeBatch);
+
+private:
+	TWeakObjectPtr<UArtGraphSubsystem> Subsystem;
 };
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "Layout/LayoutTypes.h"
+#include "GraphEdgeComponent.generated.h"
+
+USTRUCT(BlueprintType)
+struct FGraphEdgeStyle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graph Edges")
+	FColor Color = FColor::Yellow;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graph Edges",
+		meta = (ClampMin = "0.0", ToolTip = "Width of the edge in world units, 0 hides it."))
+	float Thickness = 3.f;
+};
+
+/**
+ * Draws the edges of a layout between node positions, each undirected edge once as two crossed quads.
+ *
+ * The scene proxy keeps its own copy of the node positions and the edge list, and the edge geometry in
+ * persistent GPU buffers drawn as one mesh batch, so the edges stay on screen without anyone ticking. Moving a
+ * node only sends that node's new position to the render thread, batched once per frame, where just the vertices
+ * of its edges are rewritten. Positions are in world space, the component's own transform is ignored.
+ */
+UCLASS(ClassGroup = (ArtGraph), meta = (BlueprintSpawnableComponent))
+class SISTINESIMULATOR_API UGraphEdgeComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGraphEdgeComponent();
+
+	// Style of every edge that wasn't given its own with SetEdgeStyle
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graph Edges")
+	FGraphEdgeStyle DefaultStyle;
+
+	// Replace the drawn graph. Edges index into NodePositions and get DefaultStyle. Edges with an endpoint
+	// outside NodePositions are not drawn but keep their index.
+	void SetGraph(TConstArrayView<FVector3f> InNodePositions, TConstArrayView<ForceDirected::FEdge> InEdges);
+
+	UFUNCTION(BlueprintCallable, Category = "Graph Edges")
+	void ClearGraph();
+
+	// Move one endpoint, the render thread only receives the nodes that moved since the last frame
+	void SetNodePosition(int32 Node, const FVector3f& Position);
+
+	// Restyle a single edge, by its index in the edge list passed to SetGraph
+	UFUNCTION(BlueprintCallable, Category = "Graph Edges")
+	void SetEdgeStyle(int32 Edge, const FGraphEdgeStyle& Style);
+
+	UFUNCTION(BlueprintPure, Category = "Graph Edges")
+	int32 GetNumEdges() const { return Edges.Num(); }
+
+	//~ Begin UPrimitiveComponent Interface
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	virtual void GetUsedMaterials(TArray<UMaterialInterface*>& OutMaterials, bool bGetDebugMaterials = false) const override;
+	//~ End UPrimitiveComponent Interface
+
+protected:
+	virtual void SendRenderDynamicData_Concurrent() override;
+
+private:
+	friend class FGraphEdgeSceneProxy;
+
+	struct FEdgeInstance
+	{
+		// INDEX_NONE for the placeholder of an edge SetGraph rejected
+		int32 A = INDEX_NONE;
+		int32 B = INDEX_NONE;
+		FColor Color;
+		float Thickness = 0.f;
+	};
+
+	TArray<FVector3f> NodePositions;
+	TArray<FEdgeInstance> Edges;
+
+	// Everything changed since the proxy last heard from us, each entry listed once
+	TArray<int32> DirtyNodes;
+	TBitArray<> DirtyNodeFlags;
+	TArray<int32> DirtyEdges;
+
+	// Grows to fit every position, shrinks only when the graph is replaced
+	FBox NodeBounds;
+
+	// Recompute NodeBounds from scratch and push them to the proxy
+	void RebuildBounds();
+
+	// Material the proxy draws every edge with
+	UMaterialInterface* GetEdgeMaterial() const;
+};
@@ -5,21 +5,66 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Components/StaticMeshComponent.h"
+#include "Engine/StreamableManager.h"
 #include "ArtGraph.h"
+#include "GraphEdgeComponent.h"
 #include "Untangleable.h"
+#include "Layout/FruchtermanReingoldSolver.h"
+#include "Layout/TripleBuffer.h"
+#include "Tasks/Task.h"
 #include "GraphUntangling.generated.h"
 
+class AGraphUntangling;
+class UArtGraphLayoutSubsystem;
+class UUntangleableRegistry;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGraphLayoutConverged, AGraphUntangling*, Untangler);
+
+// Solver statistics of the layouts stepped in a frame, combined on the game thread before they are reported.
+// Phase timings and energy are summed over the layouts, temperature and max displacement are the highest one.
+struct FGraphLayoutStepStats
+{
+	ForceDirected::FStepTimings Timings;
+	float Energy = 0.f;
+	float Temperature = 0.f;
+	float MaxDisplacement = 0.f;
+	int32 NumLayouts = 0;
+};
+
+UENUM(BlueprintType)
+enum class EGraphRepulsionMethod : uint8
+{
+	Exact UMETA(ToolTip = "Every pair of nodes within the cutoff. Fastest for small or very dense graphs."),
+	BarnesHut UMETA(DisplayName = "Barnes-Hut", ToolTip = "Octree approximation controlled by Barnes-Hut Theta."),
+	SpatialHash UMETA(DisplayName = "Spatial Hash Grid",
+		ToolTip = "Exact repulsion between nodes in neighboring cells of a grid with cell size equal to the cutoff. Close to linear for spread out layouts."),
+};
+
+UENUM(BlueprintType)
+enum class EGraphLayoutAlgorithm : uint8
+{
+	FruchtermanReingold UMETA(DisplayName = "Fruchterman-Reingold",
+		ToolTip = "Nodes repulse each other and edges pull them together, cooled until the layout settles."),
+	StressMajorization UMETA(DisplayName = "Stress Majorization",
+		ToolTip = "Places nodes so their distances match their graph distances. Computes the distances once, then settles in a fixed number of iterations with fewer tangles than forces."),
+};
+
 UCLASS()
 class SISTINESIMULATOR_API AGraphUntangling : public AActor
 {
 	GENERATED_BODY()
 
+	friend class UArtGraphLayoutSubsystem;
+
 public:
 	// Sets default values for this actor's properties
 	AGraphUntangling();
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph")
-	TObjectPtr<UGraphElement> TargetedGraph;
+	// Blueprints go through GetTargetedGraph / SetTargetedGraph, which keep the object pin type the property had
+	// before it became a soft reference
+	UPROPERTY(EditAnywhere, Category = "ArtGraph",
+		meta = (ToolTip = "Graph to lay out. Loaded in the background when play begins if nothing else loaded it yet, right away in the editor."))
+	TSoftObjectPtr<UGraphElement> TargetedGraph;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
 		meta = (ToolTip =
@@ -28,29 +73,163 @@ public:
 	FGameplayTagContainer SecondaryTags;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
-		meta = (DisplayName = "Fruchterman-Reingold K Constant", ToolTip =
-			"This constant determines the distance between nodes to stabilize towards."
+		meta = (ToolTip = "How node positions are computed from the graph."))
+	EGraphLayoutAlgorithm LayoutAlgorithm;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
+		meta = (DisplayName = "K Constant", ToolTip =
+			"This constant determines the distance between nodes to stabilize towards. Stress majorization places neighbors exactly this far apart."
 		))
 	float KConstantUser;
 
-	// Array of arrays of objects that implement the Untangleable interface, structured like an adjacency list.
-	// The first element of each inner array corresponds to a node, and the rest are its neighbors.
-	TArray<TArray<TScriptInterface<IUntangleable>>> UntangleableAdjacencyList;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
+		meta = (EditCondition = "LayoutAlgorithm == EGraphLayoutAlgorithm::FruchtermanReingold", ToolTip =
+			"How the repulsion between nodes is computed."
+		))
+	EGraphRepulsionMethod RepulsionMethod;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
+		meta = (EditCondition = "LayoutAlgorithm == EGraphLayoutAlgorithm::FruchtermanReingold", ClampMin = "1.0", UIMin = "100.0", UIMax = "5000.0", ToolTip =
+			"Nodes farther apart than this do not repulse each other, in world units. Also the cell size of the spatial hash grid."
+		))
+	float RepulsionCutoff;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
+		meta = (DisplayName = "Barnes-Hut Theta", EditCondition = "LayoutAlgorithm == EGraphLayoutAlgorithm::FruchtermanReingold && RepulsionMethod == EGraphRepulsionMethod::BarnesHut", ClampMin = "0.0", UIMin = "0.0", UIMax = "1.5", ToolTip =
+			"Opening angle of the Barnes-Hut approximation for repulsion. Larger is faster but less accurate; 0 computes the exact all-pairs repulsion."
+		))
+	float BarnesHutTheta;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
+		meta = (EditCondition = "LayoutAlgorithm == EGraphLayoutAlgorithm::StressMajorization", ClampMin = "1", UIMin = "10", UIMax = "100", ToolTip =
+			"Iterations stress majorization runs before the layout counts as converged. Each one visits every pair of nodes it keeps distances for."
+		))
+	int32 StressIterations;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph", AdvancedDisplay,
+		meta = (EditCondition = "LayoutAlgorithm == EGraphLayoutAlgorithm::StressMajorization", ClampMin = "0", UIMin = "0", UIMax = "200", ToolTip =
+			"Graphs above 2000 nodes only keep distances to this many pivot nodes, so memory and iteration time grow linearly with the node count. 0 keeps every pair regardless of size."
+		))
+	int32 StressPivots;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
+		meta = (ClampMin = "0", UIMin = "0", ToolTip =
+			"Number of tasks the force passes are split across. 0 uses every available core, 1 runs everything on the game thread."
+		))
+	int32 NumWorkerThreads;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph", AdvancedDisplay,
+		meta = (DisplayName = "Use SIMD Kernels", ToolTip =
+			"Use the vectorized exact repulsion kernel, SSE on x64 and NEON on 64-bit ARM. Disable to fall back to the scalar reference implementation."
+		))
+	bool bUseSimdKernels;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
+		meta = (ToolTip =
+			"Run the layout on a background task. The game thread only copies the latest finished iteration onto the actors, so the frame rate no longer depends on the graph size."
+		))
+	bool bSolveAsynchronously;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph", AdvancedDisplay,
+		meta = (EditCondition = "bSolveAsynchronously", ClampMin = "1", UIMin = "1", UIMax = "16", ToolTip =
+			"Layout iterations each background task runs before publishing its positions."
+		))
+	int32 AsyncIterationsPerTask;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
+		meta = (ClampMin = "1.0", UIMin = "10.0", UIMax = "240.0", ToolTip =
+			"Layout iterations per second of game time. Frames run as many as are due, so the layout settles at the same speed at any frame rate."
+		))
+	float IterationsPerSecond;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
+		meta = (ClampMin = "0.0", UIMin = "0.5", UIMax = "16.0", ToolTip =
+			"Game thread time the layout may spend per frame, in milliseconds. Iterations that don't fit are run on the following frames. At least one due iteration always runs."
+		))
+	float FrameBudgetMs;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph",
+		meta = (ToolTip =
+			"Layouts of a higher priority are stepped before lower ones each frame. Layouts of the same priority run side by side; once the world's shared layout budget (ArtGraph.LayoutBudgetMs) is used up, lower priorities skip the frame and keep their iterations."
+		))
+	int32 LayoutPriority;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph", AdvancedDisplay,
+		meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "10.0", ToolTip =
+			"Nodes are only moved once they drifted farther than this from where they were last written, in world units."
+		))
+	float WriteBackThreshold;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph|Convergence",
+		meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "5.0", ToolTip =
+			"The layout is considered settled while no node drifts farther than this per iteration, in world units."
+		))
+	float ConvergenceThreshold;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph|Convergence",
+		meta = (ClampMin = "0", UIMin = "0", UIMax = "200", ToolTip =
+			"Consecutive settled iterations after which the layout stops ticking until something changes. 0 keeps it running forever. Stress majorization stops after Stress Iterations instead."
+		))
+	int32 ConvergenceIterations;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph|Convergence",
+		meta = (ToolTip =
+			"When nodes or edges change after the layout started, keep it and only relax the changed nodes and their neighborhood instead of solving everything again."
+		))
+	bool bIncrementalRelayout;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph|Convergence",
+		meta = (EditCondition = "bIncrementalRelayout", ClampMin = "0", UIMin = "0", UIMax = "8", ToolTip =
+			"How many hops around a changed node are relaxed along with it. Everything farther away stays frozen."
+		))
+	int32 IncrementalHops;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph|Convergence",
+		meta = (ToolTip =
+			"Save settled layouts in the project's layout cache and start from a saved one when the graph, secondary tags, layout algorithm and K constant match."
+		))
+	bool bUseLayoutCache;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ArtGraph|Convergence",
+		meta = (EditCondition = "bUseLayoutCache", ClampMin = "0.0", UIMin = "0.0", UIMax = "50.0", ToolTip =
+			"Starting temperature when a cached layout was applied, in world units. Low values keep the cached layout as is. Stress majorization resumes from its second half of iterations instead."
+		))
+	float WarmStartTemperature;
+
+	// Broadcast when the layout settled and stopped ticking
+	UPROPERTY(BlueprintAssignable, Category = "ArtGraph|Convergence")
+	FOnGraphLayoutConverged OnLayoutConverged;
+
+	// Resume ticking after convergence. Called automatically when the graph, the matched actors or a node's
+	// position change; call it yourself after changing layout properties.
+	UFUNCTION(BlueprintCallable, Category = "ArtGraph|Convergence")
+	void WakeLayout();
+
+	UFUNCTION(BlueprintPure, Category = "ArtGraph|Convergence")
+	bool IsLayoutConverged() const { return bLayoutConverged; }
 
-	// Array of arrays of AActor pointers, mirroring UntangleableAdjacencyList.
-	// The first element of each inner array corresponds to a node actor, and the rest are its neighbor actors.
-	TArray<TArray<AActor*>> ActorAdjacencyList;
+	// TargetedGraph if it is in memory, null while it is still loading
+	UFUNCTION(BlueprintPure, Category = "ArtGraph")
+	UGraphElement* GetTargetedGraph() const { return TargetedGraph.Get(); }
+
+	// Lay out Graph instead of the current TargetedGraph, the topology is rebuilt on the next tick
+	UFUNCTION(BlueprintCallable, Category = "ArtGraph")
+	void SetTargetedGraph(UGraphElement* Graph);
 
 	// Function to manually refresh the UntangleableObjects list
 	UFUNCTION(CallInEditor, Category = "ArtGraph", meta = (DisplayName = "Refresh Untangleable Actors"))
 	void RefreshUntangleableActors();
 
+	// Compares the SIMD repulsion kernel against the scalar reference on the current positions and logs the error
+	UFUNCTION(CallInEditor, Category = "ArtGraph", meta = (DisplayName = "Validate SIMD Kernel"))
+	void ValidateSimdKernel();
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
-	// Called when the actor is constructed or properties are changed in the editor
-	virtual void OnConstruction(const FTransform& Transform) override;
+	// Called when the game ends or the actor is destroyed
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// virtual void PostEditChangeProperty(FPropertyChangedEvent &PropertyChangedEvent) override;
 
@@ -58,9 +237,18 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Components", meta = (AllowPrivateAccess = "true"))
 	UStaticMeshComponent* PreviewMesh;
 
-	// Map actors to their indices in ActorAdjacencyList for fast lookup
-	UPROPERTY()
-	TMap<AActor*, int32> ActorToIndexMap;
+	// Draws the edges between the node actors, follows them as they move
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UGraphEdgeComponent> EdgeRenderer;
+
+	// Keeps TargetedGraph in memory once it was loaded, the soft reference alone doesn't
+	UPROPERTY(Transient)
+	TObjectPtr<UGraphElement> LoadedGraph;
+
+	// One actor per layout node, indexed like the solver's graph.
+	// Together with Solver.GetGraph() this is the only copy of the untangled topology.
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> NodeActors;
 
 	// Debug property to display the constructed UntangleableObjects list in the editor
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ArtGraph",
@@ -68,22 +256,108 @@ private:
 	FString DebugAdjacencyList;
 
 	float KConstant;
-	float KSquared;
-	float Temperature; // maximum allowable movement, used for cooling mechanism
 	uint32 NumNodes;
-	TArray<FVector> Positions;
-	TArray<FVector> Movements;
 	uint32 CurrentIter;
 	uint32 MaxIter;
 
-	// Helper function to find actors implementing Untangleable
-	void FindImplementorsWithTags();
+	// Engine-independent Fruchterman-Reingold solver this actor feeds with its nodes and edges
+	ForceDirected::FFruchtermanReingoldSolver Solver;
+
+	// Background task stepping Solver while bSolveAsynchronously is set. The game thread must not touch Solver
+	// until it has completed.
+	UE::Tasks::FTask AsyncSolveTask;
+
+	// Positions published by AsyncSolveTask, written on the task and read on the game thread
+	ForceDirected::TTripleBuffer<ForceDirected::FLayoutSnapshot> AsyncSnapshots;
+
+	// Iterations run by the background solver since its positions were seeded from the actors
+	int64 AsyncIteration;
+
+	// Phase timings of the iterations run since the last CaptureStepStats, added up by whichever thread owns Solver
+	ForceDirected::FStepTimings PendingStepTimings;
+
+	// What CaptureStepStats took from the solver, until ConsumeStepStats hands it on
+	FGraphLayoutStepStats CapturedStepStats;
+	bool bStepStatsCaptured;
+
+	// Where each node actor was last moved to, used to skip write-backs below WriteBackThreshold
+	TArray<FVector3f> LastWrittenPositions;
+
+	// Whether the solver positions were taken from the actors since the last refresh. Afterwards the solver
+	// owns them and actors are only written to.
+	bool bPositionsSeeded;
+
+	// Set once the solver reported convergence and ticking was disabled
+	bool bLayoutConverged;
+
+	// Set while there is nothing to lay out, e.g. the graph is still loading. Ticking is disabled like after
+	// convergence, but nothing settled, so nobody is told.
+	bool bLayoutIdle;
+
+	// Whether WakeLayout has to be called before the layout steps again
+	bool IsLayoutSleeping() const { return bLayoutConverged || bLayoutIdle; }
+
+	// Set when the graph or the set of matching actors changed, the next tick refreshes the topology
+	bool bGraphDirty;
+
+	// Set when the set of matching actors changed, which always requires a refresh
+	bool bNodeActorsDirty;
+
+	// Adjacency generation of TargetedGraph the current topology was built from
+	uint32 BuiltGraphGeneration;
+
+	// Steps this layout together with every other one in the world, unset when the actor ticks itself
+	TWeakObjectPtr<UArtGraphLayoutSubsystem> LayoutSubsystem;
+
+	// Game time not yet simulated, in seconds. Every 1 / IterationsPerSecond of it is one iteration.
+	double StepAccumulator;
+
+	// Set by WakeLayout, the solver's convergence tracking is reset as soon as the game thread owns it
+	bool bConvergenceResetPending;
+
+	// Guards against our own write-back being mistaken for an external move
+	bool bWritingPositions;
+
+	// Nodes moved by something other than the layout since the solver last synced with the actors
+	TSet<int32> ExternallyMovedNodes;
+
+	// Graph whose change notifications are currently bound
+	TWeakObjectPtr<UGraphElement> BoundGraph;
+
+	FDelegateHandle GraphChangedHandle;
+	FDelegateHandle RegistryAddedHandle;
+	FDelegateHandle RegistryRemovedHandle;
+
+	// Graph nodes no registered actor matched at the last refresh. Only actors providing one of these
+	// require a new refresh when they are registered.
+	TSet<FGameplayTag> UnresolvedNodeTags;
+
+	// Graph tag each node actor was matched for, parallel to NodeActors
+	TArray<FGameplayTag> NodeActorTags;
+
+	// Hash of the topology, secondary tags and K constant identifying this layout in the layout cache.
+	// Nodes are numbered by tag name for it, OutCanonicalIndex maps node indices to that numbering.
+	uint64 ComputeLayoutCacheKey(std::vector<int32_t>& OutCanonicalIndex) const;
+
+	// Start the solver from the cached layout of this graph if there is one, at WarmStartTemperature
+	bool ApplyCachedLayout();
 
-	// Helper function to store the found actors in UntangleableAdjacencyList
-	void CastToUntangleableActors();
+	// Remember the current, settled layout in the layout cache
+	void StoreLayoutInCache();
 
-	// Helper to update ActorToIndexMap
-	void UpdateActorToIndexMap();
+	// Replace the solver's graph with the refreshed topology, keeping the positions of nodes whose actor was
+	// already part of it and relaxing only around the change
+	void UpdateGraphIncrementally(const std::vector<ForceDirected::FEdge>& Edges,
+	                              const TMap<const AActor*, int32>& PreviousNodeIndices);
+
+	// Helper function to find actors implementing Untangleable, filling NodeActors and the edges between them
+	void FindImplementorsWithTags(std::vector<ForceDirected::FEdge>& OutEdges);
+
+	// Index of the untangleable actors in this actor's world
+	UUntangleableRegistry* GetUntangleableRegistry() const;
+
+	// Memory used by the compiled topology (node actors plus the CSR graph), in bytes
+	SIZE_T GetGraphAllocatedSize() const;
 
 	// Helper function to initialize graph parameters
 	void InitializeGraphParameters();
@@ -91,14 +365,110 @@ private:
 	// Helper function to format the DebugUntangleableObjects string
 	void FormatDebugUntangleableObjects();
 
-	// Helper to draw lines between nodes and their neighbors
-	void DrawAdjacencyLines(float LineThickness = 2.0f, bool PersistentLines = false, float LineDuration = 5.0f,
-	                        FColor LineColor = FColor::Yellow);
+	// Copy the current actor locations into the solver positions
+	void GatherPositions();
+
+	// Start the solver positions from the current actor locations
+	void SeedPositions();
+
+	// Move the node actors to Positions in one pass, skipping nodes that moved less than WriteBackThreshold
+	// ArtGraph.DebugMessages prints every move on screen.
+	void WritePositionsToActors(const ForceDirected::FLayoutBuffers& Positions);
+
+	// Bring the idle solver up to date with the world: seed positions, pick up external moves, reset convergence
+	void SyncSolverWithActors();
+
+	// Disable ticking and broadcast OnLayoutConverged
+	void EnterConvergedState();
+
+	// Stop ticking without reporting convergence, until WakeLayout
+	void EnterIdleState();
+
+	// Watch the node actors for external moves, replacing any previous bindings
+	void BindNodeActors();
+	void UnbindNodeActors();
+
+	// In flight while TargetedGraph is being loaded
+	TSharedPtr<FStreamableHandle> TargetedGraphLoadHandle;
+
+	// Start loading TargetedGraph through the ArtGraph subsystem if it isn't in memory, the layout refreshes
+	// once it arrives. Outside of game worlds it is loaded right away. A loaded graph is pinned in LoadedGraph.
+	void RequestTargetedGraph();
+	void OnTargetedGraphLoaded();
+
+	// Watch TargetedGraph for adjacency changes
+	void BindTargetedGraph();
+	void UnbindTargetedGraph();
+
+	void OnTargetedGraphChanged(UGraphElement* Graph);
+
+	// Whether the compiled topology still matches TargetedGraph and the registered actors
+	bool IsTopologyUpToDate();
+	void OnUntangleableRegistered(AActor* Actor, const FGameplayTagContainer& Tags);
+	void OnUntangleableUnregistered(AActor* Actor, const FGameplayTagContainer& Tags);
+	void OnNodeTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags,
+	                            ETeleportType Teleport, int32 Node);
+
+	// Block until the background solver is idle so the game thread owns Solver again
+	void WaitForAsyncSolve();
+
+	// Copy the newest published snapshot onto the actors and start the next background iteration if idle
+	void TickAsync();
+
+	// Move the actors to the positions of the newest snapshot, if one was published since the last call
+	void ApplyLatestSnapshot();
+
+	// Number of tasks the force passes are split into, resolved from NumWorkerThreads
+	int32 GetNumForceTasks() const;
+
+	// Solver.Step, adding its phase timings to PendingStepTimings. Runs on whichever thread currently owns the solver.
+	void StepSolver();
+
+	// Game thread, while no task owns the solver: take the timings, energy, temperature and max displacement
+	// of the iterations run since the last call, for ConsumeStepStats
+	void CaptureStepStats();
+
+	// Game thread: combine what was captured since the last call into Stats. False if nothing was.
+	bool ConsumeStepStats(FGraphLayoutStepStats& Stats);
+
+	// Game thread: publish combined solver statistics to stats and Insights
+	static void ReportStepStats(const FGraphLayoutStepStats& Stats);
+
+	// Solver settings resolved from the user facing properties
+	ForceDirected::FSolverSettings MakeSolverSettings() const;
+
+	// Hand the compiled edges and the current node locations to EdgeRenderer
+	void UpdateEdgeRenderer();
+
+	// One frame of layout: topology changes, then a synchronous or asynchronous step
+	void TickLayout(float DeltaTime);
+
+	// A frame of synchronous layout is split in three so a UArtGraphLayoutSubsystem can run the middle part of
+	// every layout in the world in one parallel dispatch:
+
+	// Game thread: pick up topology changes. False if there is nothing to lay out and the layout went to sleep.
+	bool PrepareLayoutTick();
+
+	// Game thread: add DeltaTime to the accumulator and sync the solver with the actors.
+	// Returns the number of iterations due.
+	int32 BeginLayoutStep(float DeltaTime);
+
+	// Any thread, only touches Solver: run up to NumSteps iterations until FrameBudgetMs or Deadline (in
+	// FPlatformTime::Seconds) is reached. bSplitForces lets the solver spread each iteration over worker tasks.
+	// Returns the number of iterations run.
+	int32 RunLayoutSteps(int32 NumSteps, double Deadline, bool bSplitForces);
+
+	// Game thread: write the positions back and go to sleep once converged
+	void EndLayoutStep(int32 NumStepsRun);
 
 public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
-	// A single Fruchterman-Reingold step for current ActorAdjacencyList
+	// A single Fruchterman-Reingold step for the current graph
 	void DoStep();
+
+	// Run the iterations due after DeltaTime more game time, as many as fit in FrameBudgetMs, and write the
+	// result back once. Returns the number of iterations run.
+	int32 AdvanceLayout(float DeltaTime);
 };
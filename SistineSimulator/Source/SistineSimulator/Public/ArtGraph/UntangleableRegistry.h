@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameplayTagContainer.h"
+#include "UntangleableRegistry.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnUntangleableActorChanged, AActor* /*Actor*/,
+                                     const FGameplayTagContainer& /*Tags*/);
+
+/**
+ * Live index of the actors in a world that implement IUntangleable, keyed by their gameplay tags.
+ *
+ * Actors are picked up when they are spawned or their level is added to the world, and dropped on EndPlay,
+ * destruction or when their level is removed. Native or Blueprint actors may also register and unregister
+ * themselves explicitly, both calls are idempotent. The world is only scanned once, on the first query.
+ */
+UCLASS()
+class SISTINESIMULATOR_API UUntangleableRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Add an IUntangleable actor to the index, reading its tags once
+	UFUNCTION(BlueprintCallable, Category = "Untangleable")
+	void RegisterActor(AActor* Actor);
+
+	// Remove an actor from the index
+	UFUNCTION(BlueprintCallable, Category = "Untangleable")
+	void UnregisterActor(AActor* Actor);
+
+	// Re-read the tags of a registered actor after they changed
+	UFUNCTION(BlueprintCallable, Category = "Untangleable")
+	void UpdateActorTags(AActor* Actor);
+
+	// First registered actor carrying Tag (or one of its children) and all of RequiredTags, or null
+	AActor* FindActor(const FGameplayTag& Tag, const FGameplayTagContainer& RequiredTags);
+
+	// Tags the actor had when it was registered, or null if it isn't
+	const FGameplayTagContainer* GetActorTags(const AActor* Actor) const;
+
+	int32 GetNumActors() const { return RegisteredActors.Num(); }
+
+	// Deltas for listeners that maintain their own view of the registry
+	FOnUntangleableActorChanged OnActorRegistered;
+	FOnUntangleableActorChanged OnActorUnregistered;
+
+private:
+	// Tags of every registered actor
+	TMap<TObjectKey<AActor>, FGameplayTagContainer> RegisteredActors;
+
+	// Registered actors by each of their tags and its parents, in registration order
+	TMap<FGameplayTag, TArray<TWeakObjectPtr<AActor>>> TagToActors;
+
+	bool bPopulated = false;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+	// Register everything already in the world, once
+	void EnsurePopulated();
+
+	void AddLevelActors(const ULevel* Level);
+	void RemoveLevelActors(const ULevel* Level);
+
+	void AddToIndex(AActor* Actor, const FGameplayTagContainer& Tags);
+	void RemoveFromIndex(const AActor* Actor, const FGameplayTagContainer& Tags);
+
+	void HandleActorSpawned(AActor* Actor);
+	void HandleLevelAdded(ULevel* Level, UWorld* World);
+	void HandleLevelRemoved(ULevel* Level, UWorld* World);
+
+	UFUNCTION()
+	void HandleActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+	UFUNCTION()
+	void HandleActorDestroyed(AActor* Actor);
+};